@@ -16,7 +16,7 @@
 
 meta:
 	ADDON_NAME = ofxEasyOsc
-	ADDON_DESCRIPTION = Wrapper around ofxOsc
+	ADDON_DESCRIPTION = Easy OSC sending and receiving with its own codec and UDP socket
 	ADDON_AUTHOR = Christof Ressi
 	ADDON_TAGS = "networking"
 	ADDON_URL = 
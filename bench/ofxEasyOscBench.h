@@ -0,0 +1,56 @@
+#pragma once
+
+/// Helpers shared by the benchmarks in this directory: a wall clock timer and a global allocation counter
+/// (operator new is replaced, so only include this header from one translation unit per executable).
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<size_t> ofxEasyOscBenchAllocations(0);
+
+// not inlined, otherwise GCC pairs malloc() and free() with the operators of the standard library (-Wmismatched-new-delete)
+#if defined(__GNUC__)
+#define OFXEASYOSC_BENCH_NOINLINE __attribute__((noinline))
+#else
+#define OFXEASYOSC_BENCH_NOINLINE
+#endif
+
+OFXEASYOSC_BENCH_NOINLINE void* operator new(size_t size){
+    ofxEasyOscBenchAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)){
+        return p;
+    }
+    throw std::bad_alloc();
+}
+OFXEASYOSC_BENCH_NOINLINE void operator delete(void* p) noexcept { std::free(p); }
+OFXEASYOSC_BENCH_NOINLINE void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+class ofxEasyOscBench {
+public:
+    ofxEasyOscBench(const char* name_, size_t count_) : name(name_), count(count_) {
+        allocations = ofxEasyOscBenchAllocations.load();
+        start = std::chrono::steady_clock::now();
+    }
+    // print time and allocations per iteration
+    ~ofxEasyOscBench(){
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        const size_t n = ofxEasyOscBenchAllocations.load() - allocations;
+        std::printf("%-40s %10.1f ns %8.2f allocs\n", name, ns / count, double(n) / count);
+    }
+private:
+    const char* name;
+    size_t count;
+    size_t allocations;
+    std::chrono::steady_clock::time_point start;
+};
+
+// keep the optimizer from dropping the measured work
+template <typename T>
+inline void ofxEasyOscBenchKeep(const T& value){
+    static volatile T sink;
+    sink = value;
+    (void)sink;
+}
@@ -0,0 +1,106 @@
+// Codec benchmark: encoding and decoding a typical control message with the native codec versus the ofxOsc path,
+// which materializes every message as an ofxOscMessage (owning address string and arguments) before it is read or
+// serialized. In a headless build ofxOscMessage is the stand-in of ofxEasyOscHeadless.h, which stores arguments by
+// value; ofxOsc itself allocates one object per argument, so the numbers of the ofxOsc path are a lower bound.
+
+#include "ofxEasyOsc.h"
+#include "ofxEasyOscBench.h"
+
+static const size_t numIterations = 1000000;
+
+static void write(ofxEasyOscWriter& writer, int i){
+    writer.begin("/synth/1/voice/params", 6);
+    writer.addFloat(i * 0.5f);
+    writer.addFloat(0.25f);
+    writer.addFloat(1.5f);
+    writer.addInt32(i);
+    writer.addString("saw");
+    writer.addBool(true);
+    writer.end();
+}
+
+// what ofxOscReceiver does for every message
+static void materialize(const ofxEasyOscMessageView& view, ofxOscMessage& msg){
+    msg.setAddress(view.getAddress());
+    for (int i = 0; i < view.getNumArgs(); ++i){
+        switch (view.getArgType(i)){
+        case OFXOSC_TYPE_FLOAT: msg.addFloatArg(view.getArgAsFloat(i)); break;
+        case OFXOSC_TYPE_INT32: msg.addIntArg(view.getArgAsInt32(i)); break;
+        case OFXOSC_TYPE_STRING: msg.addStringArg(view.getArgAsString(i)); break;
+        default: msg.addBoolArg(view.getArgAsBool(i)); break;
+        }
+    }
+}
+
+static float read(const ofxEasyOscMessageView& msg){
+    return msg.getArgAsFloat(0) + msg.getArgAsFloat(1) + msg.getArgAsFloat(2) + msg.getArgAsInt32(3)
+        + msg.getArgAsCString(4)[0] + msg.getArgAsBool(5);
+}
+
+static float read(const ofxOscMessage& msg){
+    return msg.getArgAsFloat(0) + msg.getArgAsFloat(1) + msg.getArgAsFloat(2) + msg.getArgAsInt32(3)
+        + msg.getArgAsString(4)[0] + msg.getArgAsBool(5);
+}
+
+int main(){
+    ofxEasyOscWriter writer;
+    {
+        ofxEasyOscBench bench("encode: ofxEasyOscWriter", numIterations);
+        for (size_t i = 0; i < numIterations; ++i){
+            write(writer, int(i));
+            ofxEasyOscBenchKeep(writer.size());
+        }
+    }
+    {
+        ofxEasyOscBench bench("encode: ofxOscMessage + serialize", numIterations);
+        for (size_t i = 0; i < numIterations; ++i){
+            ofxOscMessage msg;
+            msg.setAddress("/synth/1/voice/params");
+            msg.addFloatArg(i * 0.5f);
+            msg.addFloatArg(0.25f);
+            msg.addFloatArg(1.5f);
+            msg.addIntArg(int(i));
+            msg.addStringArg("saw");
+            msg.addBoolArg(true);
+            writer.begin(msg.getAddress(), msg.getNumArgs());
+            for (int j = 0; j < msg.getNumArgs(); ++j){
+                switch (msg.getArgType(j)){
+                case OFXOSC_TYPE_FLOAT: writer.addFloat(msg.getArgAsFloat(j)); break;
+                case OFXOSC_TYPE_INT32: writer.addInt32(msg.getArgAsInt32(j)); break;
+                case OFXOSC_TYPE_STRING: writer.addString(msg.getArgAsString(j)); break;
+                default: writer.addBool(msg.getArgAsBool(j)); break;
+                }
+            }
+            writer.end();
+            ofxEasyOscBenchKeep(writer.size());
+        }
+    }
+
+    write(writer, 1);
+    const vector<char> packet(writer.data(), writer.data() + writer.size());
+    {
+        ofxEasyOscBench bench("decode: ofxEasyOscMessageView", numIterations);
+        for (size_t i = 0; i < numIterations; ++i){
+            ofxEasyOscParsePacket(packet.data(), packet.size(), [](const char* data, size_t size){
+                ofxEasyOscMessageView msg;
+                if (msg.parse(data, size)){
+                    ofxEasyOscBenchKeep(read(msg));
+                }
+            });
+        }
+    }
+    {
+        ofxEasyOscBench bench("decode: ofxOscMessage", numIterations);
+        for (size_t i = 0; i < numIterations; ++i){
+            ofxEasyOscParsePacket(packet.data(), packet.size(), [](const char* data, size_t size){
+                ofxEasyOscMessageView view;
+                if (view.parse(data, size)){
+                    ofxOscMessage msg;
+                    materialize(view, msg);
+                    ofxEasyOscBenchKeep(read(msg));
+                }
+            });
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,77 @@
+// Forward error correction: recovered-loss rate against bandwidth overhead for group sizes of 4 - 16 under 1 - 10% random loss.
+// Encoder and decoder are connected in-process, every datagram (data and parity) is dropped with the given probability.
+// "residual" is the share of datagrams which are still missing after recovery, "overhead" the extra bytes on the wire
+// relative to the plain datagrams, "parity" the part of it spent on parity packets (the rest are the 48 byte FEC headers,
+// which dominate for small messages).
+
+#include "ofxEasyOsc.h"
+#include "ofxEasyOscBench.h"
+#include <random>
+
+static const size_t numDatagrams = 200000;
+
+// 16 messages of varying size with 'numFloats' floats each
+static vector<vector<char>> makeMessages(size_t numFloats){
+    vector<vector<char>> messages;
+    ofxEasyOscWriter writer;
+    for (int i = 0; i < 16; ++i){
+        writer.begin("/performer/1/position", numFloats + 1);
+        for (size_t j = 0; j < numFloats; ++j){
+            writer.addFloat(i * 0.1f + j);
+        }
+        writer.addString(string(i * 4, 'x'));
+        writer.end();
+        messages.emplace_back(writer.data(), writer.data() + writer.size());
+    }
+    return messages;
+}
+
+int main(){
+    std::printf("%8s %6s %6s %10s %10s %10s %10s %10s\n", "payload", "group", "loss", "overhead", "parity", "recovered", "residual", "ns/dgram");
+    const size_t numFloats[] = { 3, 64 };
+    const size_t groupSizes[] = { 4, 8, 16 };
+    const double lossRates[] = { 0.01, 0.02, 0.05, 0.1 };
+    for (size_t n : numFloats){
+        const vector<vector<char>> messages = makeMessages(n);
+        size_t payload = 0;
+        for (auto& msg : messages){
+            payload += msg.size();
+        }
+        payload /= messages.size();
+        for (size_t groupSize : groupSizes){
+            for (double loss : lossRates){
+                ofxEasyOscFecEncoder encoder;
+                encoder.setGroupSize(groupSize);
+                encoder.resize(1);
+                ofxEasyOscFecDecoder decoder;
+                const ofxEasyOscEndpoint from;
+                std::mt19937 random(1);
+                std::bernoulli_distribution drop(loss);
+                size_t numLost = 0;
+                size_t numDelivered = 0;
+                size_t plainBytes = 0;
+                size_t wireBytes = 0;
+                const auto start = std::chrono::steady_clock::now();
+                auto sendTo = [&](const char* data, size_t size, size_t){
+                    wireBytes += size;
+                    if (drop(random)){
+                        numLost += !std::memcmp(data, "#bundle", 8);
+                        return;
+                    }
+                    decoder.decode(data, size, from, [&](const char*, size_t){ ++numDelivered; });
+                };
+                for (size_t i = 0; i < numDatagrams; ++i){
+                    const vector<char>& msg = messages[i % messages.size()];
+                    plainBytes += msg.size();
+                    encoder.send(msg.data(), msg.size(), 0, sendTo);
+                }
+                const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+                std::printf("%6zu B %6zu %5.0f%% %9.1f%% %9.1f%% %9.1f%% %9.2f%% %10.1f\n", payload, groupSize, loss * 100,
+                    100.0 * (wireBytes - plainBytes) / plainBytes, 100.0 * encoder.getStats().numParityBytes / plainBytes,
+                    numLost ? 100.0 * decoder.getStats().numRecovered / numLost : 100.0,
+                    100.0 * (numDatagrams - numDelivered) / numDatagrams, ns / numDatagrams);
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,76 @@
+// LZ4 compression of bulk-state bundles: compression ratio and throughput of ofxEasyOscLz4Compress() and
+// ofxEasyOscLz4Decompress() for parameter snapshots of 10 - 60 KB and, as the worst case, a bundle of noise blobs.
+
+#include "ofxEasyOsc.h"
+#include "ofxEasyOscBench.h"
+#include <random>
+
+// a bundle of 'numMessages' parameter messages, or of blobs with random bytes
+static vector<char> makeBundle(size_t numMessages, bool bNoise){
+    vector<char> bundle(16, 0);
+    std::memcpy(bundle.data(), "#bundle", 8);
+    ofxEasyOscWrite64(bundle.data() + 8, 1);
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> value(0, 1);
+    ofxEasyOscWriter writer;
+    char noise[64];
+    for (size_t i = 0; i < numMessages; ++i){
+        const string address = "/synth/" + to_string(i / 16) + "/param/" + to_string(i % 16);
+        writer.begin(address, 3);
+        if (bNoise){
+            for (char& c : noise){
+                c = static_cast<char>(random());
+            }
+            writer.addBlob(noise, sizeof(noise));
+        } else {
+            writer.addFloat(value(random));
+            writer.addInt32(static_cast<int32_t>(i % 16));
+            writer.addString(i % 2 ? "linear" : "exponential");
+        }
+        writer.end();
+        char size[4];
+        ofxEasyOscWrite32(size, static_cast<uint32_t>(writer.size()));
+        bundle.insert(bundle.end(), size, size + 4);
+        bundle.insert(bundle.end(), writer.data(), writer.data() + writer.size());
+    }
+    return bundle;
+}
+
+int main(){
+    std::printf("%-22s %8s %8s %8s %12s %12s\n", "bundle", "bytes", "lz4", "ratio", "comp MB/s", "decomp MB/s");
+    struct Case { const char* name; size_t numMessages; bool bNoise; };
+    const Case cases[] = {
+        { "parameters (10 KB)", 200, false },
+        { "parameters (30 KB)", 600, false },
+        { "parameters (60 KB)", 1200, false },
+        { "noise blobs (60 KB)", 625, true },
+    };
+    vector<uint32_t> table;
+    for (const Case& c : cases){
+        const vector<char> bundle = makeBundle(c.numMessages, c.bNoise);
+        vector<char> compressed(ofxEasyOscLz4Bound(bundle.size()));
+        vector<char> decompressed(bundle.size());
+        // repeat for about 100 MB
+        const size_t numIterations = 100000000 / bundle.size();
+        size_t size = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < numIterations; ++i){
+            size = ofxEasyOscLz4Compress(bundle.data(), bundle.size(), compressed.data(), table);
+        }
+        const double compressTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        bool bOk = true;
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < numIterations; ++i){
+            bOk &= ofxEasyOscLz4Decompress(compressed.data(), size, decompressed.data(), decompressed.size());
+        }
+        const double decompressTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (!bOk || decompressed != bundle){
+            std::printf("%s: round trip failed\n", c.name);
+            return 1;
+        }
+        const double megabytes = 1e-6 * bundle.size() * numIterations;
+        std::printf("%-22s %8zu %8zu %7.2fx %12.0f %12.0f\n", c.name, bundle.size(), size,
+            double(bundle.size()) / size, megabytes / compressTime, megabytes / decompressTime);
+    }
+    return 0;
+}
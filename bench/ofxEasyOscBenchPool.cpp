@@ -0,0 +1,87 @@
+// Allocations on the receive path for listeners taking an ofxOscMessage. The conversion of a message is measured with a fresh
+// ofxOscMessage per message (like the receiver did before the pool) and with a message from an ofxEasyOscMessagePool, then the
+// whole receive path: ofxEasyOscReceiver dispatching to a message-typed listener and to the default listener.
+
+#include "ofxEasyOsc.h"
+#include "ofxEasyOscBench.h"
+
+static const size_t numIterations = 1000000;
+
+// dispatch without a socket
+class Receiver : public ofxEasyOscReceiver {
+public:
+    using ofxEasyOscReceiver::processPacket;
+};
+
+static void materialize(const ofxEasyOscMessageView& view, ofxOscMessage& msg){
+    msg.setAddress(view.getAddressData(), view.getAddressLength());
+    size_t length;
+    for (int i = 0; i < view.getNumArgs(); ++i){
+        switch (view.getArgType(i)){
+        case OFXOSC_TYPE_FLOAT: msg.addFloatArg(view.getArgAsFloat(i)); break;
+        case OFXOSC_TYPE_INT32: msg.addIntArg(view.getArgAsInt32(i)); break;
+        case OFXOSC_TYPE_STRING: {
+            const char* str = view.getArgAsCString(i, &length);
+            msg.addStringArg(str, length);
+            break;
+        }
+        default: msg.addBoolArg(view.getArgAsBool(i)); break;
+        }
+    }
+}
+
+static vector<char> encode(const char* address, int i){
+    ofxEasyOscWriter writer;
+    writer.begin(address, 4);
+    writer.addFloat(i * 0.5f);
+    writer.addInt32(i);
+    writer.addString("a string longer than the small string buffer");
+    writer.addBool(true);
+    writer.end();
+    return vector<char>(writer.data(), writer.data() + writer.size());
+}
+
+int main(){
+    const vector<char> packets[] = { encode("/listener", 1), encode("/unknown", 2) };
+    float sink = 0;
+    function<void(const ofxOscMessage&)> listener = [&](const ofxOscMessage& msg){
+        // getArgAsString() would return a copy
+        sink += msg.getArgAsFloat(0) + msg.getArgAsInt32(1);
+    };
+
+    ofxEasyOscMessageView view;
+    view.parse(packets[0].data(), packets[0].size());
+    {
+        ofxEasyOscBench bench("convert: fresh ofxOscMessage", numIterations);
+        for (size_t i = 0; i < numIterations; ++i){
+            ofxOscMessage msg;
+            materialize(view, msg);
+            listener(msg);
+        }
+    }
+    {
+        ofxEasyOscMessagePool pool;
+        ofxEasyOscBench bench("convert: pooled ofxOscMessage", numIterations);
+        for (size_t i = 0; i < numIterations; ++i){
+            ofxOscMessage& msg = pool.acquire();
+            materialize(view, msg);
+            listener(msg);
+            pool.release();
+        }
+    }
+
+    Receiver receiver;
+    receiver.add("/listener", listener);
+    receiver.setDefaultListener(listener);
+    const ofxEasyOscEndpoint from;
+    {
+        ofxEasyOscBench bench("receiver: listener + default listener", numIterations);
+        for (size_t i = 0; i < numIterations; ++i){
+            const vector<char>& packet = packets[i & 1];
+            receiver.processPacket(packet.data(), packet.size(), from);
+        }
+    }
+    std::printf("%-40s %10zu messages\n", "pool size", receiver.getMessagePool().getNumAllocated());
+    ofxEasyOscBenchKeep(sink);
+    return 0;
+}
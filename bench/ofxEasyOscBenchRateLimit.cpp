@@ -0,0 +1,43 @@
+// Cost of the rate limiter per message: an address without a limit (repeated, so the previous address matches, and alternating
+// between 64 addresses, so the table is probed) and an address with a limit high enough to let every message through.
+
+#include "ofxEasyOsc.h"
+#include "ofxEasyOscBench.h"
+
+static const size_t numIterations = 10000000;
+
+int main(){
+    ofxEasyOscRateLimiter limiter;
+    limiter.setAddressLimit("/limited", ofxEasyOscRateLimit(1e12, 1e12));
+    vector<string> addresses;
+    for (int i = 0; i < 64; ++i){
+        addresses.push_back("/unlimited/" + to_string(i));
+    }
+    const char data[64] = {};
+    size_t numSent = 0;
+    auto sendTo = [&](const char*, size_t, size_t, uint32_t){ ++numSent; };
+    {
+        ofxEasyOscBench bench("unlimited, same address", numIterations);
+        for (size_t i = 0; i < numIterations; ++i){
+            limiter.send(data, sizeof(data), addresses[0].data(), addresses[0].size(), 0, 1, sendTo);
+        }
+    }
+    {
+        ofxEasyOscBench bench("unlimited, 64 addresses", numIterations);
+        for (size_t i = 0; i < numIterations; ++i){
+            const string& address = addresses[i & 63];
+            limiter.send(data, sizeof(data), address.data(), address.size(), 0, 1, sendTo);
+        }
+    }
+    {
+        ofxEasyOscBench bench("limited", numIterations);
+        for (size_t i = 0; i < numIterations; ++i){
+            limiter.send(data, sizeof(data), "/limited", 8, 0, 1, sendTo);
+        }
+    }
+    if (numSent != 3 * numIterations){
+        std::printf("%zu messages were held back\n", 3 * numIterations - numSent);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,24 @@
+// Driver for compilers without libFuzzer: runs LLVMFuzzerTestOneInput() once for every file given on the
+// command line, so a corpus (or a crash reproducer) can be replayed under the sanitizers of any compiler.
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+int main(int argc, char** argv){
+    for (int i = 1; i < argc; ++i){
+        std::ifstream file(argv[i], std::ios::binary);
+        if (!file){
+            std::fprintf(stderr, "can't open %s\n", argv[i]);
+            return 1;
+        }
+        std::vector<char> input((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t*>(input.data()), input.size());
+    }
+    std::printf("ran %d inputs\n", argc - 1);
+    return 0;
+}
@@ -0,0 +1,68 @@
+// libFuzzer target for the OSC codec: ofxEasyOscParsePacket() unpacks the datagram, every message goes through
+// ofxEasyOscMessageView::parse() and, if accepted, all of its arguments are read in both directions (the view
+// caches a cursor).
+//
+//   cmake -S . -B build -DCMAKE_CXX_COMPILER=clang++ -DOFXEASYOSC_BUILD_FUZZERS=ON
+//   cmake --build build --target ofxEasyOscFuzzParse
+//   ./build/ofxEasyOscFuzzParse -max_len=1500 corpus/
+
+#include "ofxEasyOsc.h"
+
+static void readArg(const ofxEasyOscMessageView& msg, int index, uint64_t& sink){
+    const char* blobData;
+    size_t blobSize;
+    switch (msg.getArgType(index)){
+    case OFXOSC_TYPE_INT32: case OFXOSC_TYPE_CHAR: case OFXOSC_TYPE_TRUE: case OFXOSC_TYPE_FALSE:
+        sink += msg.getArgAsInt32(index) + msg.getArgAsBool(index);
+        break;
+    case OFXOSC_TYPE_INT64:
+        sink += msg.getArgAsInt64(index);
+        break;
+    case OFXOSC_TYPE_FLOAT: case OFXOSC_TYPE_DOUBLE:
+        sink += static_cast<uint64_t>(msg.getArgAsFloat(index) != 0) + (msg.getArgAsDouble(index) != 0);
+        break;
+    case OFXOSC_TYPE_STRING: case OFXOSC_TYPE_SYMBOL:
+        sink += msg.getArgAsString(index).size();
+        break;
+    case OFXOSC_TYPE_BLOB:
+        if (msg.getArgAsBlob(index, blobData, blobSize) && blobSize){
+            // touch both ends, ASan catches a blob reaching past the packet
+            sink += static_cast<unsigned char>(blobData[0]) + static_cast<unsigned char>(blobData[blobSize - 1]);
+        }
+        break;
+    case OFXOSC_TYPE_TIMETAG:
+        sink += msg.getArgAsTimetag(index);
+        break;
+    case OFXOSC_TYPE_MIDI_MESSAGE:
+        sink += msg.getArgAsMidiMessage(index);
+        break;
+    case OFXOSC_TYPE_RGBA_COLOR:
+        sink += msg.getArgAsRgbaColor(index);
+        break;
+    default:
+        break;
+    }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size){
+    // the receiver hands 4 byte aligned buffers to the codec
+    vector<char> packet(reinterpret_cast<const char*>(data), reinterpret_cast<const char*>(data) + size);
+    uint64_t sink = 0;
+    ofxEasyOscParsePacket(packet.data(), packet.size(), [&](const char* msgData, size_t msgSize){
+        ofxEasyOscMessageView msg;
+        if (!msg.parse(msgData, msgSize)){
+            return;
+        }
+        sink += msg.getAddressLength() + msg.getTypeTagsLength();
+        for (int i = 0; i < msg.getNumArgs(); ++i){
+            readArg(msg, i, sink);
+        }
+        for (int i = msg.getNumArgs() - 1; i >= 0; --i){
+            readArg(msg, i, sink);
+        }
+        readArg(msg, msg.getNumArgs(), sink);
+    });
+    volatile uint64_t result = sink;
+    (void)result;
+    return 0;
+}
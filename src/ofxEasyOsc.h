@@ -1,11 +1,44 @@
 #pragma once
 
-#include "ofMain.h"
-#include "ofxOsc.h"
+#include "ofxEasyOscAdapter.h"
 #include <unordered_map>
 #include <unordered_set>
 #include <list>
+#include <algorithm>
+#include <functional>
+#include <bitset>
+#include <iterator>
+#include <type_traits>
 #include <typeinfo>
+#include <chrono>
+#include <random>
+#include <limits>
+// UDP socket used by ofxEasyOscSender and ofxEasyOscReceiver
+#include "ofxEasyOscSocket.h"
+// network impairment simulator wrapping the socket
+#include "ofxEasyOscImpairment.h"
+// OSC encoder/decoder
+#include "ofxEasyOscCodec.h"
+// token bucket rate limits used by ofxEasyOscSender
+#include "ofxEasyOscRateLimiter.h"
+// sequence numbers and loss statistics
+#include "ofxEasyOscSequence.h"
+// selective reliable delivery
+#include "ofxEasyOscReliable.h"
+// forward error correction
+#include "ofxEasyOscFec.h"
+// LZ4 compressed envelopes
+#include "ofxEasyOscCompression.h"
+// quantized float arrays
+#include "ofxEasyOscQuantize.h"
+// delta encoded messages
+#include "ofxEasyOscDelta.h"
+// state snapshots for late joiners
+#include "ofxEasyOscState.h"
+// receiver driven subscriptions
+#include "ofxEasyOscSubscription.h"
+// pre-filter for the registered addresses
+#include "ofxEasyOscAddressFilter.h"
 // template classes used by ofxEasyOscReceiver
 #include "ofxEasyOscTemplates.h"
 
@@ -16,94 +49,919 @@
 
 /// You can send a single message via the send() method.
 /// Method chaining is supported: mySender.send("foo", x).send("bar", y);
+/// Messages are encoded directly into a reusable buffer (see ofxEasyOscWriter) and sent as plain (unbundled) datagrams.
+///
+/// 64-bit values (double, long, long long) are sent according to the encoding:
+/// OFXEASYOSC_ENCODING_COMPACT (default) narrows them to float/int32, which every OSC implementation (e.g. Pd) understands,
+/// OFXEASYOSC_ENCODING_PRECISE sends them as 'd'/'h'. ofxEasyOscTimetag is always sent as 't'.
+/// Integers outside the int32 range are sent as 'h' in both encodings, since narrowing would change their value.
+/// Change the default with setEncoding() or choose per message: mySender.send(OFXEASYOSC_ENCODING_PRECISE, "/time", t);
+
+///
+/// Booleans are sent according to the bool encoding (see setBoolEncoding()):
+/// OFXEASYOSC_BOOL_INT (default) sends 0/1 as int32 (understood by every OSC implementation),
+/// OFXEASYOSC_BOOL_TAGS sends OSC 1.1 'T'/'F' type tags without any payload,
+/// OFXEASYOSC_BOOL_BLOB additionally packs vector<bool> and std::bitset<N> into a single blob:
+/// bit count (int32) followed by the bits, LSB first (512 bools -> 68 bytes).
+/// ofxEasyOscReceiver understands all three encodings.
+
+/// A sender can have several destinations (addDestination()), every message is sent to all of them.
+/// Rate limits (token buckets) can be set per address, per address prefix and per destination, see ofxEasyOscRateLimiter.
+/// Messages which are held back by a limit are sent by update(), so call it regularly if you use KEEP_LATEST or DROP_OLDEST:
+/// mySender.setRateLimit("/dmx", 40).setDestinationRateLimit(0, 500, 50);
+///
+/// With setSequenceNumbers(true) every datagram carries a sequence number (see ofxEasyOscSequence.h), so the receiver
+/// can count lost, duplicated and reordered datagrams. Plain OSC peers receive an additional "/#s" message.
+///
+/// Critical addresses can be sent reliably (see ofxEasyOscReliable.h): mySender.setReliable("/scene/go");
+/// The receiver acknowledges them and the sender retransmits lost messages from a bounded buffer. Acknowledgements are
+/// read and timed out messages are retransmitted by update(), so call it regularly (e.g. once per frame).
+///
+/// For lossy links where a round trip is too slow, setForwardErrorCorrection(K) adds an XOR parity packet after every K datagrams,
+/// so the receiver can rebuild a single lost datagram per group (see ofxEasyOscFec.h). update() closes incomplete groups.
+///
+/// Large datagrams (e.g. parameter snapshots) can be LZ4 compressed: mySender.setCompression(1024);
+/// Destinations only get compressed datagrams after their receiver has answered a probe (see ofxEasyOscCompression.h),
+/// plain OSC peers keep getting uncompressed datagrams.
+///
+/// Large messages which change only a little between sends (e.g. LED arrays) can be delta encoded: mySender.setDelta("/leds", 60);
+/// Only the changed 32-bit words are sent, with a full keyframe every 60 messages (see ofxEasyOscDelta.h). After a lost datagram
+/// the receiver waits for the next keyframe, so don't combine it with rate limits which drop messages of that address.
+///
+/// With setStateSync(true) the sender remembers the last message of every address and sends the whole table to receivers
+/// which ask for it (see ofxEasyOscState.h and ofxEasyOscReceiver::setAutoResync()). Requests are read and the snapshots
+/// are sent by update(). Only destinations are answered unless setStateOpenRequests(true) is used. Exclude addresses which must not be replayed: mySender.setStateSync(true).setStateExclude("/cue");
+///
+/// With setSubscriptionFilter(true) destinations only get the addresses their receiver has announced (see ofxEasyOscSubscription.h
+/// and ofxEasyOscReceiver::setSubscriptions()). Messages which no destination wants aren't serialized at all.
+/// Announcements are read by update().
+
+/// Containers are sent flattened, e.g. vector<ofVec3f> of size N sends 3*N floats. Every type that can be iterated
+/// with begin()/end() works: STL containers, std::array, raw arrays and nested containers like vector<vector<float>>.
+/// Character ranges (strings) are always sent as a single string.
+///
+/// Large float arrays can be quantized to 8 or 16 bit fixed point and sent as a single blob (see ofxEasyOscQuantize.h),
+/// either with a fixed range or with the smallest/largest value of the data: mySender.send("/faders", ofxEasyOscQuantize(faders, 8, 0, 1));
+/// ofxEasyOscReceiver decodes them straight into bound containers of floats, vectors and matrices.
+
+// trait for ranges (anything with begin()/end()) which aren't strings
+template <typename T>
+class ofxEasyOscIsRange {
+    template <typename U>
+    static auto test(int) -> decltype(std::begin(std::declval<const U&>()) != std::end(std::declval<const U&>()),
+                                      typename std::decay<decltype(*std::begin(std::declval<const U&>()))>::type());
+    template <typename U>
+    static void test(...);
+    typedef decltype(test<T>(0)) element;
+public:
+    static const bool value = !std::is_void<element>::value && !std::is_same<element, char>::value;
+};
+
+/// Vectors and matrices (ofVec2f/3f/4f, ofMatrix3x3, ofMatrix4x4 and the corresponding glm types) are sent as plain floats
+/// (matrices in memory order). They, as well as contiguous containers of floats/vectors/matrices (vector, std::array, raw arrays),
+/// are copied straight from their float storage with a single byte swap pass.
+
+// number of floats in types which consist of nothing but floats
+template <typename T> struct ofxEasyOscFloatCount { static const size_t value = 0; };
+template <> struct ofxEasyOscFloatCount<float> { static const size_t value = 1; };
+template <> struct ofxEasyOscFloatCount<ofVec2f> { static const size_t value = 2; };
+template <> struct ofxEasyOscFloatCount<ofVec3f> { static const size_t value = 3; };
+template <> struct ofxEasyOscFloatCount<ofVec4f> { static const size_t value = 4; };
+template <> struct ofxEasyOscFloatCount<ofMatrix3x3> { static const size_t value = 9; };
+template <> struct ofxEasyOscFloatCount<ofMatrix4x4> { static const size_t value = 16; };
+#ifdef OFXEASYOSC_HAS_GLM
+template <> struct ofxEasyOscFloatCount<glm::vec2> { static const size_t value = 2; };
+template <> struct ofxEasyOscFloatCount<glm::vec3> { static const size_t value = 3; };
+template <> struct ofxEasyOscFloatCount<glm::vec4> { static const size_t value = 4; };
+template <> struct ofxEasyOscFloatCount<glm::mat3> { static const size_t value = 9; };
+template <> struct ofxEasyOscFloatCount<glm::mat4> { static const size_t value = 16; };
+#endif
+
+// trait for types which can be copied as a float array (no padding)
+template <typename T>
+struct ofxEasyOscIsFloatStruct {
+    static const bool value = ofxEasyOscFloatCount<T>::value > 0 && sizeof(T) == ofxEasyOscFloatCount<T>::value * sizeof(float);
+};
+template <> struct ofxEasyOscIsFloatStruct<void> { static const bool value = false; };
+
+// trait for contiguous ranges (raw arrays or containers with data() and size()) of float structs
+template <typename T>
+class ofxEasyOscIsFloatArray {
+    template <typename U>
+    static auto test(int) -> typename std::remove_cv<typename std::remove_pointer<decltype(std::declval<const U&>().data() + std::declval<const U&>().size())>::type>::type;
+    template <typename U>
+    static void test(...);
+public:
+    typedef typename std::conditional<std::is_array<T>::value, typename std::remove_cv<typename std::remove_all_extents<T>::type>::type,
+                                      decltype(test<T>(0))>::type element;
+    static const bool value = ofxEasyOscIsFloatStruct<element>::value && (std::is_array<T>::value ? std::rank<T>::value == 1 : true);
+};
+
+// quantize a contiguous range of floats/vectors/matrices (bits = 8 or 16) to the range [min, max]
+template <typename TRange>
+inline ofxEasyOscQuantized ofxEasyOscQuantize(const TRange& range, int bits, float min, float max){
+    static_assert(ofxEasyOscIsFloatArray<TRange>::value, "ofxEasyOscQuantize: needs a contiguous range of floats, vectors or matrices");
+    typedef typename ofxEasyOscIsFloatArray<TRange>::element element;
+    const size_t size = std::end(range) - std::begin(range);
+    return ofxEasyOscQuantized(size ? reinterpret_cast<const float*>(&*std::begin(range)) : nullptr,
+                               size * ofxEasyOscFloatCount<element>::value, ofxEasyOscFloatCount<element>::value, bits, min, max, false);
+}
+
+// same, but with the smallest and largest value of the data as the range
+template <typename TRange>
+inline ofxEasyOscQuantized ofxEasyOscQuantize(const TRange& range, int bits = 16){
+    ofxEasyOscQuantized q = ofxEasyOscQuantize(range, bits, 0, 0);
+    q.bAutoRange = true;
+    return q;
+}
+
+enum ofxEasyOscEncoding {
+    OFXEASYOSC_ENCODING_COMPACT,
+    OFXEASYOSC_ENCODING_PRECISE
+};
+
+enum ofxEasyOscBoolEncoding {
+    OFXEASYOSC_BOOL_INT,
+    OFXEASYOSC_BOOL_TAGS,
+    OFXEASYOSC_BOOL_BLOB
+};
 
 class ofxEasyOscSender {
 public:
-    ofxEasyOscSender() {}
-    ofxEasyOscSender(const string& address, int portNumber) { sender.setup(address, portNumber); }
+    ofxEasyOscSender() : encoding(OFXEASYOSC_ENCODING_COMPACT), boolEncoding(OFXEASYOSC_BOOL_INT), bSequence(false), stream(0) {}
+    ofxEasyOscSender(const string& host, int portNumber)
+        : encoding(OFXEASYOSC_ENCODING_COMPACT), boolEncoding(OFXEASYOSC_BOOL_INT), bSequence(false), stream(0) { setup(host, portNumber); }
+
+    // set a single destination
+    void setup(const string& host, int portNumber);
+    // add another destination (messages are sent to all destinations). returns the index of the destination.
+    size_t addDestination(const string& host, int portNumber);
+    size_t getNumDestinations() const { return destinations.size(); }
+    const ofxEasyOscEndpoint& getDestination(size_t index) const { return destinations[index]; }
+
+    // rate limit for an address: 'rate' messages per second with bursts of up to 'burst' messages
+    ofxEasyOscSender& setRateLimit(const string& address, double rate, double burst = 1,
+                                   ofxEasyOscRatePolicy policy = OFXEASYOSC_RATE_KEEP_LATEST, size_t queueSize = 16);
+    // same for every address starting with 'prefix' (each address gets its own bucket, the longest prefix wins)
+    ofxEasyOscSender& setPrefixRateLimit(const string& prefix, double rate, double burst = 1,
+                                         ofxEasyOscRatePolicy policy = OFXEASYOSC_RATE_KEEP_LATEST, size_t queueSize = 16);
+    // total rate of messages to a destination
+    ofxEasyOscSender& setDestinationRateLimit(size_t destination, double rate, double burst = 1,
+                                              ofxEasyOscRatePolicy policy = OFXEASYOSC_RATE_DROP_OLDEST, size_t queueSize = 16);
+    ofxEasyOscSender& removeRateLimits();
+    // statistics (number of messages dropped/held back by rate limits)
+    const ofxEasyOscRateLimiter& getRateLimiter() const { return rateLimiter; }
+
+    // send messages which have been held back by rate limits
+    void update();
 
-    void setup(const string& address, int portNumber) { sender.setup(address, portNumber); }
+    // attach a sequence number to every datagram (counted per destination)
+    ofxEasyOscSender& setSequenceNumbers(bool bEnable);
+    bool getSequenceNumbers() const { return bSequence; }
+    // random id of the stream, changes whenever sequence numbers are enabled
+    uint32_t getStreamId() const { return stream; }
+
+    // deliver messages of an address reliably (acknowledged and retransmitted if necessary)
+    ofxEasyOscSender& setReliable(const string& address);
+    // same for every address starting with 'prefix'
+    ofxEasyOscSender& setReliablePrefix(const string& prefix);
+    ofxEasyOscSender& removeReliable();
+    // retransmit timeout in milliseconds (doubled with every retry) and number of retries before a message is given up
+    ofxEasyOscSender& setReliableTimeout(double ms, int maxRetries = 10);
+    // maximum number of unacknowledged messages per destination (at most 64)
+    ofxEasyOscSender& setReliableBufferSize(size_t numMessages);
+    // statistics and number of unacknowledged messages
+    const ofxEasyOscReliableSender& getReliableSender() const { return reliable; }
+
+    // send a parity packet after every 'groupSize' datagrams (at most 32, 0 = off). reliable messages are not included.
+    ofxEasyOscSender& setForwardErrorCorrection(size_t groupSize);
+    size_t getForwardErrorCorrection() const { return fec.getGroupSize(); }
+    // incomplete groups are closed by update() after this time (default 10 ms)
+    ofxEasyOscSender& setFecFlushInterval(double ms) { fec.setFlushInterval(ms); return *this; }
+    const ofxEasyOscFecStats& getFecStats() const { return fec.getStats(); }
+
+    // compress datagrams of at least 'threshold' bytes (0 = off). without negotiation every destination gets compressed
+    // datagrams right away (only if you know that all of them are ofxEasyOscReceivers).
+    ofxEasyOscSender& setCompression(size_t threshold, bool bNegotiate = true) { compressor.setThreshold(threshold, bNegotiate); return *this; }
+    size_t getCompression() const { return compressor.getThreshold(); }
+    const ofxEasyOscCompressionStats& getCompressionStats() const { return compressor.getStats(); }
+
+    // send only the changed parts of the messages of an address, with a full keyframe every 'keyframeInterval' messages
+    ofxEasyOscSender& setDelta(const string& address, int keyframeInterval = 30);
+    ofxEasyOscSender& removeDelta();
+    const ofxEasyOscDeltaStats& getDeltaStats() const { return delta.getStats(); }
+
+    // keep the last message of every address and answer state requests
+    ofxEasyOscSender& setStateSync(bool bEnable) { state.setEnabled(bEnable); return *this; }
+    bool getStateSync() const { return state.isEnabled(); }
+    // don't store/replay addresses starting with 'prefix'
+    ofxEasyOscSender& setStateExclude(const string& prefix) { state.exclude(prefix); return *this; }
+    // maximum size of the snapshot bundles (default 1472 bytes) and bundles sent per update() call (default 32)
+    ofxEasyOscSender& setStateBundleSize(size_t bytes, size_t burst = 32) { state.setBundleSize(bytes); state.setBurst(burst); return *this; }
+    // also answer peers which aren't destinations, each at most once per 'interval' seconds (and only a few per interval).
+    // only use it in trusted networks: the source of a request can be spoofed.
+    ofxEasyOscSender& setStateOpenRequests(bool bEnable, double interval = 1) { state.setOpen(bEnable, interval); return *this; }
+    // send the whole table to a destination without a request
+    ofxEasyOscSender& sendState(size_t destination) { state.snapshot(destinations[destination]); return *this; }
+    const ofxEasyOscStateStats& getStateStats() const { return state.getStats(); }
+
+    // only send the addresses which the receivers have subscribed to (destinations which don't announce anything get everything)
+    ofxEasyOscSender& setSubscriptionFilter(bool bEnable) { subscriptions.setEnabled(bEnable); return *this; }
+    bool getSubscriptionFilter() const { return subscriptions.isEnabled(); }
+    // the destination has announced its subscriptions
+    bool hasSubscriptions(size_t destination) const { return subscriptions.isKnown(destination); }
+    const ofxEasyOscSubscriptionStats& getSubscriptionStats() const { return subscriptions.getStats(); }
+
+    // simulate a bad network for testing (loss, latency, jitter, reordering, duplication, bandwidth cap).
+    // delayed datagrams are sent by update() and by the following send() calls.
+    ofxEasyOscSender& setImpairment(const ofxEasyOscImpairment& impairment) { socket.setImpairment(impairment); return *this; }
+    ofxEasyOscSender& removeImpairment() { socket.removeImpairment(); return *this; }
+    const ofxEasyOscImpairmentStats& getImpairmentStats() const { return socket.getImpairmentStats(); }
+
+    // default encoding for 64-bit values
+    ofxEasyOscSender& setEncoding(ofxEasyOscEncoding enc) { encoding = enc; return *this; }
+    ofxEasyOscEncoding getEncoding() const { return encoding; }
+
+    // encoding for bools, vector<bool> and std::bitset
+    ofxEasyOscSender& setBoolEncoding(ofxEasyOscBoolEncoding enc) { boolEncoding = enc; return *this; }
+    ofxEasyOscBoolEncoding getBoolEncoding() const { return boolEncoding; }
 	
+    // the address can be a string, a C string/string literal or a string_view (no temporary strings are created)
     template <typename... Args>
     ofxEasyOscSender& send(const string& address, const Args&... args);
+
+    template <typename... Args>
+    ofxEasyOscSender& send(const char* address, const Args&... args);
+
+#ifdef OFXEASYOSC_HAS_STRING_VIEW
+    template <typename... Args>
+    ofxEasyOscSender& send(std::string_view address, const Args&... args);
+#endif
+
+    // send with a specific encoding (only for this message)
+    template <typename TAddress, typename... Args>
+    ofxEasyOscSender& send(ofxEasyOscEncoding enc, const TAddress& address, const Args&... args);
+
+    // send a message you have built yourself
+    ofxEasyOscSender& sendMessage(const ofxOscMessage& msg);
     
 protected:
-    ofxOscSender sender;
+    ofxEasyOscImpairedSocket socket;
+    vector<ofxEasyOscEndpoint> destinations;
+    ofxEasyOscRateLimiter rateLimiter;
+    ofxEasyOscWriter writer;
+    ofxEasyOscEncoding encoding;
+    ofxEasyOscBoolEncoding boolEncoding;
+    // sequence numbers
+    bool bSequence;
+    uint32_t stream;
+    vector<uint32_t> sequences; // next sequence number per destination
+    ofxEasyOscSequenceHeader header;
+    // reliable delivery
+    ofxEasyOscReliableSender reliable;
+    // forward error correction
+    ofxEasyOscFecEncoder fec;
+    // compression
+    ofxEasyOscCompressor compressor;
+    // delta encoding
+    ofxEasyOscDeltaEncoder delta;
+    // last-value table
+    ofxEasyOscStateTable state;
+    // interests of the destinations
+    ofxEasyOscSubscriptionFilter subscriptions;
+
+    // leave room for the sequence/reliable/FEC headers
+    void updateMaxSize();
+    // read acknowledgements and compression probes
+    void receiveControl();
+
+    template <typename... Args>
+    void sendArgs(const char* address, size_t length, const Args&... args);
+    // returns false if no destination has subscribed to the address. 'id' is the interned address.
+    bool isWanted(const char* address, size_t length, uint32_t& id);
+    // same for a held back message and a single destination (only parsed again if its address isn't interned)
+    bool isWanted(size_t destination, const char* data, size_t size, uint32_t id);
+    // send the encoded message to all destinations which want it (through the rate limits)
+    void transmit(const char* address, size_t length, uint32_t id);
+    // is the encoded message (or its delta/keyframe) reliable?
+    bool isReliable(const char* data, size_t size) const;
+    // send a single datagram to a destination
+    void sendTo(const char* data, size_t size, size_t destination, bool bReliable);
+    // through the FEC layer
+    void sendDatagram(const char* data, size_t size, size_t destination);
 	
 	// string argument
     template <typename... Args>
-    void fill(ofxOscMessage& msg, const string& arg, const Args&... remain);
+    void fill(ofxEasyOscWriter& msg, const string& arg, const Args&... remain);
+
+    // C string argument (also string literals)
+    template <typename... Args>
+    void fill(ofxEasyOscWriter& msg, const char* arg, const Args&... remain);
+
+#ifdef OFXEASYOSC_HAS_STRING_VIEW
+    // string_view argument
+    template <typename... Args>
+    void fill(ofxEasyOscWriter& msg, std::string_view arg, const Args&... remain);
+#endif
 
     // bool argument
     template <typename... Args>
-    void fill(ofxOscMessage& msg, bool arg, const Args&... remain);
+    void fill(ofxEasyOscWriter& msg, bool arg, const Args&... remain);
 
     // byte argument
     template <typename... Args>
-    void fill(ofxOscMessage& msg, unsigned char arg, const Args&... remain);
+    void fill(ofxEasyOscWriter& msg, unsigned char arg, const Args&... remain);
 
     // int argument
     template <typename... Args>
-    void fill(ofxOscMessage& msg, int arg, const Args&... remain);
+    void fill(ofxEasyOscWriter& msg, int arg, const Args&... remain);
 
     // float argument
     template <typename... Args>
-    void fill(ofxOscMessage& msg, float arg, const Args&... remain);
+    void fill(ofxEasyOscWriter& msg, float arg, const Args&... remain);
 
     // double argument
     template <typename... Args>
-    void fill(ofxOscMessage& msg, double arg, const Args&... remain);
+    void fill(ofxEasyOscWriter& msg, double arg, const Args&... remain);
+
+    // 64-bit integer arguments (int64_t is either long or long long)
+    template <typename... Args>
+    void fill(ofxEasyOscWriter& msg, long arg, const Args&... remain);
+
+    template <typename... Args>
+    void fill(ofxEasyOscWriter& msg, long long arg, const Args&... remain);
 
-    // ofVec2f argument
+    // time tag argument
     template <typename... Args>
-    void fill(ofxOscMessage& msg, const ofVec2f& arg, const Args&... remain);
+    void fill(ofxEasyOscWriter& msg, const ofxEasyOscTimetag& arg, const Args&... remain);
+
+    // vector/matrix argument (ofVec2f, ofVec3f, ofVec4f, ofMatrix3x3, ofMatrix4x4, glm::vec2/3/4, glm::mat3/4)
+    template <typename T, typename... Args>
+    typename std::enable_if<(ofxEasyOscFloatCount<T>::value > 1)>::type
+    fill(ofxEasyOscWriter& msg, const T& arg, const Args&... remain);
 
-    // ofVec3f argument
+    // vector<bool> argument
     template <typename... Args>
-    void fill(ofxOscMessage& msg, const ofVec3f& arg, const Args&... remain);
+    void fill(ofxEasyOscWriter& msg, const vector<bool>& vec, const Args&... remain);
 
-    // ofVec4f argument
+    // std::bitset argument
+    template <size_t N, typename... Args>
+    void fill(ofxEasyOscWriter& msg, const std::bitset<N>& bits, const Args&... remain);
+
+    // quantized float array argument
     template <typename... Args>
-    void fill(ofxOscMessage& msg, const ofVec4f& arg, const Args&... remain);
+    void fill(ofxEasyOscWriter& msg, const ofxEasyOscQuantized& arg, const Args&... remain);
+
+    // range argument (STL containers, std::array, raw arrays, nested containers...)
+    template <typename TRange, typename... Args>
+    typename std::enable_if<ofxEasyOscIsRange<TRange>::value>::type
+    fill(ofxEasyOscWriter& msg, const TRange& range, const Args&... remain);
 
-    // STL container argument
-    template <typename T,
-            template <typename E, typename Allocator = std::allocator<E>> class Container,
-              typename... Args>
-    void fill(ofxOscMessage& msg, const Container<T>& vec, const Args&... remain);
+    // contiguous ranges of floats/vectors/matrices are copied in one go
+    template <typename TRange>
+    void fillRange(ofxEasyOscWriter& msg, const TRange& range, std::true_type);
+    template <typename TRange>
+    void fillRange(ofxEasyOscWriter& msg, const TRange& range, std::false_type);
 
     // dummy
-    void fill(ofxOscMessage& msg);
+    void fill(ofxEasyOscWriter& msg);
+
+    // number of OSC arguments a value expands to (used to reserve the message buffer once)
+    size_t countArgs() const { return 0; }
+    template <typename T, typename... Args>
+    size_t countArgs(const T& first, const Args&... remain) const { return count(first) + countArgs(remain...); }
+
+    template <typename T>
+    typename std::enable_if<!ofxEasyOscIsRange<T>::value, size_t>::type
+    count(const T&) const { return ofxEasyOscFloatCount<T>::value > 1 ? ofxEasyOscFloatCount<T>::value : 1; }
+    size_t count(const vector<bool>& vec) const { return boolEncoding == OFXEASYOSC_BOOL_BLOB ? 1 : vec.size(); }
+    template <size_t N>
+    size_t count(const std::bitset<N>&) const { return boolEncoding == OFXEASYOSC_BOOL_BLOB ? 1 : N; }
+    template <typename TRange>
+    typename std::enable_if<ofxEasyOscIsRange<TRange>::value, size_t>::type
+    count(const TRange& range) const {
+        size_t n = 0;
+        for (const auto& element : range){
+            n += count(element);
+        }
+        return n;
+    }
 };
 
+inline void ofxEasyOscSender::setup(const string& host, int portNumber){
+    destinations.clear();
+    sequences.clear();
+    if (bSequence){
+        // the counters start again, so it's a new stream (otherwise the receiver drops the next datagrams as duplicates)
+        std::random_device random;
+        stream = random();
+    }
+    // every per-destination layer starts from scratch, the new host must not inherit the state of the old one
+    reliable.reset();
+    fec.reset();
+    compressor.resize(0);
+    rateLimiter.resize(0);
+    subscriptions.resize(0);
+    addDestination(host, portNumber);
+}
+
+inline size_t ofxEasyOscSender::addDestination(const string& host, int portNumber){
+    ofxEasyOscEndpoint destination;
+    if (!destination.set(host, portNumber)){
+        ofLogError("ofxEasyOscSender") << "couldn't resolve host " << host;
+    }
+    destinations.push_back(destination);
+    sequences.push_back(0);
+    reliable.resize(destinations.size());
+    fec.resize(destinations.size());
+    compressor.resize(destinations.size());
+    subscriptions.resize(destinations.size());
+    // the new destination needs a base for the deltas
+    delta.requestKeyframes();
+    // any free port
+    if (!socket.isOpen() && !socket.bind(0)){
+        ofLogError("ofxEasyOscSender") << "couldn't open socket";
+    }
+    return destinations.size() - 1;
+}
+
+inline ofxEasyOscSender& ofxEasyOscSender::setRateLimit(const string& address, double rate, double burst,
+                                                        ofxEasyOscRatePolicy policy, size_t queueSize){
+    rateLimiter.setAddressLimit(address, ofxEasyOscRateLimit(rate, burst, policy, queueSize));
+    return *this;
+}
+
+inline ofxEasyOscSender& ofxEasyOscSender::setPrefixRateLimit(const string& prefix, double rate, double burst,
+                                                              ofxEasyOscRatePolicy policy, size_t queueSize){
+    rateLimiter.setPrefixLimit(prefix, ofxEasyOscRateLimit(rate, burst, policy, queueSize));
+    return *this;
+}
+
+inline ofxEasyOscSender& ofxEasyOscSender::setDestinationRateLimit(size_t destination, double rate, double burst,
+                                                                   ofxEasyOscRatePolicy policy, size_t queueSize){
+    rateLimiter.setDestinationLimit(destination, ofxEasyOscRateLimit(rate, burst, policy, queueSize));
+    return *this;
+}
+
+inline ofxEasyOscSender& ofxEasyOscSender::removeRateLimits(){
+    rateLimiter.clear();
+    return *this;
+}
+
+inline ofxEasyOscSender& ofxEasyOscSender::setSequenceNumbers(bool bEnable){
+    if (bEnable && !bSequence){
+        // a new stream, so receivers don't mistake a restarted sender for old duplicates
+        std::random_device random;
+        stream = random();
+        std::fill(sequences.begin(), sequences.end(), 0);
+    }
+    bSequence = bEnable;
+    updateMaxSize();
+    return *this;
+}
+
+inline ofxEasyOscSender& ofxEasyOscSender::setDelta(const string& address, int keyframeInterval){
+    delta.add(address, keyframeInterval);
+    updateMaxSize();
+    return *this;
+}
+
+inline ofxEasyOscSender& ofxEasyOscSender::removeDelta(){
+    delta.clear();
+    updateMaxSize();
+    return *this;
+}
+
+inline ofxEasyOscSender& ofxEasyOscSender::setReliable(const string& address){
+    reliable.addAddress(address);
+    updateMaxSize();
+    return *this;
+}
+
+inline ofxEasyOscSender& ofxEasyOscSender::setReliablePrefix(const string& prefix){
+    reliable.addPrefix(prefix);
+    updateMaxSize();
+    return *this;
+}
+
+inline ofxEasyOscSender& ofxEasyOscSender::removeReliable(){
+    reliable.clear();
+    updateMaxSize();
+    return *this;
+}
+
+inline ofxEasyOscSender& ofxEasyOscSender::setReliableTimeout(double ms, int maxRetries){
+    reliable.setTimeout(ms);
+    reliable.setMaxRetries(maxRetries);
+    return *this;
+}
+
+inline ofxEasyOscSender& ofxEasyOscSender::setReliableBufferSize(size_t numMessages){
+    reliable.setBufferSize(numMessages);
+    return *this;
+}
+
+inline ofxEasyOscSender& ofxEasyOscSender::setForwardErrorCorrection(size_t groupSize){
+    fec.setGroupSize(groupSize);
+    updateMaxSize();
+    return *this;
+}
+
+inline void ofxEasyOscSender::updateMaxSize(){
+    // the reliable header is the larger one. the FEC header comes on top of the sequence header.
+    size_t overhead = reliable.isActive() ? ofxEasyOscReliableSender::overhead
+                    : bSequence ? ofxEasyOscSequenceHeader::overhead : 0;
+    if (fec.isActive()){
+        overhead += ofxEasyOscFecEncoder::overhead;
+    }
+    // keyframes are wrapped into a bundle
+    if (delta.isActive()){
+        overhead += ofxEasyOscDeltaEncoder::overhead;
+    }
+    writer.setMaxSize(65507 - overhead);
+}
+
+inline void ofxEasyOscSender::receiveControl(){
+    // control messages are tiny, only subscriptions take up to one MTU
+    char buffer[1536];
+    ofxEasyOscEndpoint from;
+    ofxEasyOscMessageView msg;
+    int size;
+    while ((size = socket.receive(buffer, sizeof(buffer), &from)) > 0){
+        if (!msg.parse(buffer, size)){
+            continue;
+        }
+        if (state.isEnabled() && ofxEasyOscStateTable::isRequest(msg)){
+            // other peers only if allowed (and rate limited), a spoofed request must not turn us into an amplifier
+            if (std::find(destinations.begin(), destinations.end(), from) != destinations.end()
+                    || state.acceptPeer(from, ofxEasyOscRateLimiter::now())){
+                state.snapshot(from);
+            }
+            continue;
+        }
+        for (size_t i = 0; i < destinations.size(); ++i){
+            if (destinations[i] == from){
+                bool bChanged;
+                if (subscriptions.isEnabled() && subscriptions.receive(msg, i, bChanged)){
+                    // the destination might have subscribed to delta encoded addresses
+                    if (bChanged){
+                        delta.requestKeyframes();
+                    }
+                } else if (!compressor.receive(msg, i)){
+                    reliable.receive(msg, i, [this](const char* data, size_t n, size_t index){
+                        socket.sendTo(data, n, destinations[index]);
+                    });
+                }
+                break;
+            }
+        }
+    }
+}
+
+inline void ofxEasyOscSender::update(){
+    if (reliable.isActive() || compressor.isNegotiating() || state.isEnabled() || subscriptions.isEnabled()){
+        receiveControl();
+    }
+    if (state.isSending()){
+        state.update([this](const char* data, size_t size, const ofxEasyOscEndpoint& to){
+            socket.sendTo(data, size, to);
+        });
+    }
+    if (compressor.isNegotiating()){
+        compressor.update([this](const char* data, size_t size, size_t index){
+            socket.sendTo(data, size, destinations[index]);
+        });
+    }
+    if (reliable.isActive()){
+        reliable.update([this](const char* data, size_t size, size_t index){
+            socket.sendTo(data, size, destinations[index]);
+        });
+    }
+    if (fec.isActive()){
+        fec.update([this](const char* data, size_t size, size_t index){
+            socket.sendTo(data, size, destinations[index]);
+        });
+    }
+    if (socket.isImpaired()){
+        socket.flush();
+    }
+    if (rateLimiter.isActive()){
+        rateLimiter.update(destinations.size(), [this](const char* data, size_t size, size_t index, uint32_t id){
+            if (subscriptions.isEnabled() && !isWanted(index, data, size, id)){
+                ++subscriptions.getStats().numSkipped;
+                return;
+            }
+            sendTo(data, size, index, isReliable(data, size));
+        });
+    }
+}
+
+inline bool ofxEasyOscSender::isWanted(const char* address, size_t length, uint32_t& id){
+    id = ofxEasyOscSubscriptionFilter::noId;
+    if (subscriptions.isEnabled()){
+        id = subscriptions.lookup(address, length);
+        if (!subscriptions.isWanted(address, length, id)){
+            ++subscriptions.getStats().numFiltered;
+            return false;
+        }
+    }
+    return true;
+}
+
+inline bool ofxEasyOscSender::isWanted(size_t destination, const char* data, size_t size, uint32_t id){
+    if (id != ofxEasyOscSubscriptionFilter::noId){
+        return subscriptions.isWanted(destination, id);
+    }
+    return subscriptions.isWanted(destination, data, size);
+}
+
+inline void ofxEasyOscSender::transmit(const char* address, size_t length, uint32_t id){
+    const char* data = writer.data();
+    size_t size = writer.size();
+    if (state.isEnabled()){
+        state.store(data, size, address, length);
+    }
+    // the delta state is shared by all destinations
+    if (delta.isActive() && delta.encode(data, size, address, length)){
+        data = delta.data();
+        size = delta.size();
+    }
+    const bool bFilter = subscriptions.isEnabled();
+    // decided by the original address, the packet might be a delta or a keyframe
+    const bool bReliable = reliable.isActive() && reliable.isReliable(address, length);
+    if (rateLimiter.isActive()){
+        rateLimiter.send(data, size, address, length, id, destinations.size(),
+                         [&](const char* d, size_t n, size_t index, uint32_t messageId){
+            // held back messages (of other addresses) go first
+            if (bFilter && !(d == data ? subscriptions.isWanted(index, id, address, length) : isWanted(index, d, n, messageId))){
+                ++subscriptions.getStats().numSkipped;
+                return;
+            }
+            sendTo(d, n, index, d == data ? bReliable : isReliable(d, n));
+        });
+    } else {
+        for (size_t i = 0; i < destinations.size(); ++i){
+            if (bFilter && !subscriptions.isWanted(i, id, address, length)){
+                ++subscriptions.getStats().numSkipped;
+                continue;
+            }
+            sendTo(data, size, i, bReliable);
+        }
+    }
+}
+
+inline bool ofxEasyOscSender::isReliable(const char* data, size_t size) const {
+    if (!reliable.isActive()){
+        return false;
+    }
+    size_t length;
+    const char* address = ofxEasyOscDeltaAddress(data, size, length);
+    return reliable.isReliable(address, length);
+}
+
+inline void ofxEasyOscSender::sendTo(const char* data, size_t size, size_t destination, bool bReliable){
+    // compress before the headers are added
+    if (compressor.isActive() && size >= compressor.getThreshold()){
+        if (compressor.compress(data, size, destination, [this](const char* d, size_t n, size_t index){
+            socket.sendTo(d, n, destinations[index]);
+        })){
+            data = compressor.data();
+            size = compressor.size();
+        }
+    }
+    if (bReliable){
+        // reliable messages have their own sequence numbers
+        reliable.send(data, size, destination, [this](const char* d, size_t n, size_t index){
+            socket.sendTo(d, n, destinations[index]);
+        });
+    } else if (bSequence){
+        // numbered after the rate limits, so held back or dropped messages don't show up as losses
+        const vector<char>& envelope = header.wrap(data, size, stream, sequences[destination]++);
+        sendDatagram(envelope.data(), envelope.size(), destination);
+    } else {
+        sendDatagram(data, size, destination);
+    }
+}
+
+inline void ofxEasyOscSender::sendDatagram(const char* data, size_t size, size_t destination){
+    if (fec.isActive()){
+        fec.send(data, size, destination, [this](const char* d, size_t n, size_t index){
+            socket.sendTo(d, n, destinations[index]);
+        });
+    } else {
+        socket.sendTo(data, size, destinations[destination]);
+    }
+}
+
 // send a OSC message
 template <typename... Args>
 inline ofxEasyOscSender& ofxEasyOscSender::send(const string& address, const Args&... args){
-	ofxOscMessage msg;
-    msg.setAddress(address);
+    sendArgs(address.data(), address.size(), args...);
+    return *this;
+}
+
+template <typename... Args>
+inline ofxEasyOscSender& ofxEasyOscSender::send(const char* address, const Args&... args){
+    sendArgs(address, std::strlen(address), args...);
+    return *this;
+}
+
+#ifdef OFXEASYOSC_HAS_STRING_VIEW
+template <typename... Args>
+inline ofxEasyOscSender& ofxEasyOscSender::send(std::string_view address, const Args&... args){
+    sendArgs(address.data(), address.size(), args...);
+    return *this;
+}
+#endif
+
+template <typename... Args>
+inline void ofxEasyOscSender::sendArgs(const char* address, size_t length, const Args&... args){
+    uint32_t id;
+    if (!isWanted(address, length, id)){
+        return;
+    }
+    writer.begin(address, length, countArgs(args...));
 
     if (sizeof...(args)){
-        fill(msg, args...);
+        fill(writer, args...);
     }
 
-	sender.sendMessage(msg);
+    if (writer.end()){
+        transmit(address, length, id);
+    } else {
+        ofLogError("ofxEasyOscSender") << "message " << string(address, length) << " too large";
+    }
+}
+
+// send a OSC message with a specific encoding
+template <typename TAddress, typename... Args>
+inline ofxEasyOscSender& ofxEasyOscSender::send(ofxEasyOscEncoding enc, const TAddress& address, const Args&... args){
+    const ofxEasyOscEncoding saved = encoding;
+    encoding = enc;
+    send(address, args...);
+    encoding = saved;
+    return *this;
+}
+
+// encode an ofxOscMessage
+inline ofxEasyOscSender& ofxEasyOscSender::sendMessage(const ofxOscMessage& msg){
+    writer.begin(msg.getAddress(), msg.getNumArgs());
+
+    for (int i = 0; i < msg.getNumArgs(); ++i){
+        switch (msg.getArgType(i)){
+        case OFXOSC_TYPE_INT32:
+            writer.addInt32(msg.getArgAsInt32(i));
+            break;
+        case OFXOSC_TYPE_INT64:
+            writer.addInt64(msg.getArgAsInt64(i));
+            break;
+        case OFXOSC_TYPE_FLOAT:
+            writer.addFloat(msg.getArgAsFloat(i));
+            break;
+        case OFXOSC_TYPE_DOUBLE:
+            writer.addDouble(msg.getArgAsDouble(i));
+            break;
+        case OFXOSC_TYPE_STRING:
+            writer.addString(msg.getArgAsString(i));
+            break;
+        case OFXOSC_TYPE_SYMBOL: {
+            const string symbol = msg.getArgAsSymbol(i);
+            writer.addSymbol(symbol.data(), symbol.size());
+            break;
+        }
+        case OFXOSC_TYPE_CHAR:
+            writer.addChar(msg.getArgAsChar(i));
+            break;
+        case OFXOSC_TYPE_MIDI_MESSAGE:
+            writer.addMidiMessage(msg.getArgAsMidiMessage(i));
+            break;
+        case OFXOSC_TYPE_TRUE:
+        case OFXOSC_TYPE_FALSE:
+            writer.addBool(msg.getArgAsBool(i));
+            break;
+        case OFXOSC_TYPE_NONE:
+            writer.addNil();
+            break;
+        case OFXOSC_TYPE_TRIGGER:
+            writer.addImpulse();
+            break;
+        case OFXOSC_TYPE_TIMETAG:
+            writer.addTimetag(msg.getArgAsTimetag(i));
+            break;
+        case OFXOSC_TYPE_RGBA_COLOR:
+            writer.addRgbaColor(msg.getArgAsRgbaColor(i));
+            break;
+        case OFXOSC_TYPE_BLOB: {
+            ofBuffer blob = msg.getArgAsBlob(i);
+            writer.addBlob(blob.getData(), blob.size());
+            break;
+        }
+        default:
+            ofLogError("ofxEasyOscSender") << "unknown argument type " << msg.getArgType(i);
+            break;
+        }
+    }
+
+    if (writer.end()){
+        const string& address = msg.getAddress();
+        uint32_t id;
+        if (isWanted(address.data(), address.size(), id)){
+            transmit(address.data(), address.size(), id);
+        }
+    } else {
+        ofLogError("ofxEasyOscSender") << "message " << msg.getAddress() << " too large";
+    }
     return *this;
 }
 
 // add string arg:
 template <typename... Args>
-inline void ofxEasyOscSender::fill(ofxOscMessage& msg, const string& arg, const Args&... remain){
-    msg.addStringArg(arg);
+inline void ofxEasyOscSender::fill(ofxEasyOscWriter& msg, const string& arg, const Args&... remain){
+    msg.addString(arg);
+
+    if (sizeof...(remain)){
+        fill(msg, remain...);
+    }
+}
+
+// add C string arg:
+template <typename... Args>
+inline void ofxEasyOscSender::fill(ofxEasyOscWriter& msg, const char* arg, const Args&... remain){
+    msg.addString(arg);
+
+    if (sizeof...(remain)){
+        fill(msg, remain...);
+    }
+}
+
+#ifdef OFXEASYOSC_HAS_STRING_VIEW
+// add string_view arg:
+template <typename... Args>
+inline void ofxEasyOscSender::fill(ofxEasyOscWriter& msg, std::string_view arg, const Args&... remain){
+    msg.addString(arg.data(), arg.size());
 
     if (sizeof...(remain)){
         fill(msg, remain...);
     }
 }
+#endif
 
 // add bool arg:
 template <typename... Args>
-inline void ofxEasyOscSender::fill(ofxOscMessage& msg, bool arg, const Args&... remain){
-    msg.addIntArg(arg);
+inline void ofxEasyOscSender::fill(ofxEasyOscWriter& msg, bool arg, const Args&... remain){
+    if (boolEncoding == OFXEASYOSC_BOOL_INT){
+        msg.addInt32(arg);
+    } else {
+        msg.addBool(arg);
+    }
+
+    if (sizeof...(remain)){
+        fill(msg, remain...);
+    }
+}
+
+// add vector<bool> arg:
+template <typename... Args>
+inline void ofxEasyOscSender::fill(ofxEasyOscWriter& msg, const vector<bool>& vec, const Args&... remain){
+    const size_t length = vec.size();
+
+    if (boolEncoding == OFXEASYOSC_BOOL_BLOB){
+        if (char* bits = msg.addBlob(4 + (length + 7) / 8)){
+            ofxEasyOscWrite32(bits, static_cast<uint32_t>(length));
+            for (size_t i = 0; i < length; ++i){
+                if (vec[i]){
+                    bits[4 + i / 8] |= 1 << (i % 8);
+                }
+            }
+        }
+    } else {
+        for (size_t i = 0; i < length; ++i){
+            fill(msg, static_cast<bool>(vec[i]));
+        }
+    }
+
+    if (sizeof...(remain)){
+        fill(msg, remain...);
+    }
+}
+
+// add std::bitset arg:
+template <size_t N, typename... Args>
+inline void ofxEasyOscSender::fill(ofxEasyOscWriter& msg, const std::bitset<N>& vec, const Args&... remain){
+    if (boolEncoding == OFXEASYOSC_BOOL_BLOB){
+        if (char* bits = msg.addBlob(4 + (N + 7) / 8)){
+            ofxEasyOscWrite32(bits, static_cast<uint32_t>(N));
+            for (size_t i = 0; i < N; ++i){
+                if (vec[i]){
+                    bits[4 + i / 8] |= 1 << (i % 8);
+                }
+            }
+        }
+    } else {
+        for (size_t i = 0; i < N; ++i){
+            fill(msg, static_cast<bool>(vec[i]));
+        }
+    }
 
     if (sizeof...(remain)){
         fill(msg, remain...);
@@ -112,8 +970,8 @@ inline void ofxEasyOscSender::fill(ofxOscMessage& msg, bool arg, const Args&...
 
 // add byte arg:
 template <typename... Args>
-inline void ofxEasyOscSender::fill(ofxOscMessage& msg, unsigned char arg, const Args&... remain){
-    msg.addIntArg(arg);
+inline void ofxEasyOscSender::fill(ofxEasyOscWriter& msg, unsigned char arg, const Args&... remain){
+    msg.addInt32(arg);
 
     if (sizeof...(remain)){
         fill(msg, remain...);
@@ -122,8 +980,8 @@ inline void ofxEasyOscSender::fill(ofxOscMessage& msg, unsigned char arg, const
 
 // add int arg:
 template <typename... Args>
-inline void ofxEasyOscSender::fill(ofxOscMessage& msg, int arg, const Args&... remain){
-    msg.addIntArg(arg);
+inline void ofxEasyOscSender::fill(ofxEasyOscWriter& msg, int arg, const Args&... remain){
+    msg.addInt32(arg);
 
     if (sizeof...(remain)){
         fill(msg, remain...);
@@ -132,8 +990,8 @@ inline void ofxEasyOscSender::fill(ofxOscMessage& msg, int arg, const Args&... r
 
 // add float arg:
 template <typename... Args>
-inline void ofxEasyOscSender::fill(ofxOscMessage& msg, float arg, const Args&... remain){
-    msg.addFloatArg(arg);
+inline void ofxEasyOscSender::fill(ofxEasyOscWriter& msg, float arg, const Args&... remain){
+    msg.addFloat(arg);
 
     if (sizeof...(remain)){
         fill(msg, remain...);
@@ -142,73 +1000,164 @@ inline void ofxEasyOscSender::fill(ofxOscMessage& msg, float arg, const Args&...
 
 // add double arg:
 template <typename... Args>
-inline void ofxEasyOscSender::fill(ofxOscMessage& msg, double arg, const Args&... remain){
-    msg.addFloatArg(arg);
+inline void ofxEasyOscSender::fill(ofxEasyOscWriter& msg, double arg, const Args&... remain){
+    if (encoding == OFXEASYOSC_ENCODING_PRECISE){
+        msg.addDouble(arg);
+    } else {
+        msg.addFloat(arg);
+    }
 
     if (sizeof...(remain)){
         fill(msg, remain...);
     }
 }
 
-// add ofVec2f arg:
+// add long arg:
 template <typename... Args>
-inline void ofxEasyOscSender::fill(ofxOscMessage& msg, const ofVec2f& arg, const Args&... remain){
-    msg.addFloatArg(arg.x);
-    msg.addFloatArg(arg.y);
+inline void ofxEasyOscSender::fill(ofxEasyOscWriter& msg, long arg, const Args&... remain){
+    // values which don't fit into int32 are sent as 'h' in compact mode as well
+    if (encoding == OFXEASYOSC_ENCODING_PRECISE || arg < std::numeric_limits<int32_t>::min() || arg > std::numeric_limits<int32_t>::max()){
+        msg.addInt64(arg);
+    } else {
+        msg.addInt32(static_cast<int32_t>(arg));
+    }
 
     if (sizeof...(remain)){
         fill(msg, remain...);
     }
 }
 
-// add ofVec3f arg:
+// add long long arg:
 template <typename... Args>
-inline void ofxEasyOscSender::fill(ofxOscMessage& msg, const ofVec3f& arg, const Args&... remain){
-    msg.addFloatArg(arg.x);
-    msg.addFloatArg(arg.y);
-    msg.addFloatArg(arg.z);
+inline void ofxEasyOscSender::fill(ofxEasyOscWriter& msg, long long arg, const Args&... remain){
+    // values which don't fit into int32 are sent as 'h' in compact mode as well
+    if (encoding == OFXEASYOSC_ENCODING_PRECISE || arg < std::numeric_limits<int32_t>::min() || arg > std::numeric_limits<int32_t>::max()){
+        msg.addInt64(arg);
+    } else {
+        msg.addInt32(static_cast<int32_t>(arg));
+    }
 
     if (sizeof...(remain)){
         fill(msg, remain...);
     }
 }
 
-// add ofVec4f arg:
+// add time tag arg:
 template <typename... Args>
-inline void ofxEasyOscSender::fill(ofxOscMessage& msg, const ofVec4f& arg, const Args&... remain){
-    msg.addFloatArg(arg.x);
-    msg.addFloatArg(arg.y);
-    msg.addFloatArg(arg.z);
-    msg.addFloatArg(arg.w);
+inline void ofxEasyOscSender::fill(ofxEasyOscWriter& msg, const ofxEasyOscTimetag& arg, const Args&... remain){
+    msg.addTimetag(arg.value);
+
+    if (sizeof...(remain)){
+        fill(msg, remain...);
+    }
+}
+
+// add vector/matrix arg:
+template <typename T, typename... Args>
+inline typename std::enable_if<(ofxEasyOscFloatCount<T>::value > 1)>::type
+ofxEasyOscSender::fill(ofxEasyOscWriter& msg, const T& arg, const Args&... remain){
+    static_assert(ofxEasyOscIsFloatStruct<T>::value, "vector/matrix type must consist of nothing but floats");
+    // the types are standard layout and start with their first float
+    msg.addFloats(reinterpret_cast<const float*>(&arg), ofxEasyOscFloatCount<T>::value);
 
     if (sizeof...(remain)){
         fill(msg, remain...);
     }
 }
 
-// add STL container arg:
-template <typename T,
-        template <typename E, typename Allocator = std::allocator<E>> class Container,
-          typename... Args>
-inline void ofxEasyOscSender::fill(ofxOscMessage& msg, const Container<T>& vec, const Args&... remain){
-    const int length = vec.size();
+// add quantized float array arg:
+template <typename... Args>
+inline void ofxEasyOscSender::fill(ofxEasyOscWriter& msg, const ofxEasyOscQuantized& arg, const Args&... remain){
+    if (char* blob = msg.addBlob(ofxEasyOscQuantizedSize(arg.size, arg.bits))){
+        ofxEasyOscQuantizeFloats(arg, blob);
+    }
 
-    for (int i = 0; i < length; ++i){
-        fill(msg, vec[i]);
+    if (sizeof...(remain)){
+        fill(msg, remain...);
     }
+}
+
+// add range arg (iterate instead of indexing, so lists and sets are O(n) as well):
+template <typename TRange, typename... Args>
+inline typename std::enable_if<ofxEasyOscIsRange<TRange>::value>::type
+ofxEasyOscSender::fill(ofxEasyOscWriter& msg, const TRange& range, const Args&... remain){
+    fillRange(msg, range, std::integral_constant<bool, ofxEasyOscIsFloatArray<TRange>::value>());
 
     if (sizeof...(remain)){
         fill(msg, remain...);
     }
 }
 
+template <typename TRange>
+inline void ofxEasyOscSender::fillRange(ofxEasyOscWriter& msg, const TRange& range, std::true_type){
+    typedef typename ofxEasyOscIsFloatArray<TRange>::element element;
+    const size_t size = std::end(range) - std::begin(range);
+    if (size){
+        msg.addFloats(reinterpret_cast<const float*>(&*std::begin(range)), size * ofxEasyOscFloatCount<element>::value);
+    }
+}
+
+template <typename TRange>
+inline void ofxEasyOscSender::fillRange(ofxEasyOscWriter& msg, const TRange& range, std::false_type){
+    for (const auto& element : range){
+        fill(msg, element);
+    }
+}
+
 	
 // dummy
-inline void ofxEasyOscSender::fill(ofxOscMessage& msg){
+inline void ofxEasyOscSender::fill(ofxEasyOscWriter& /*msg*/){
     cout << "I'm a dummy!\n";
 }
 
 
+//*----------------------------------------------------------------------------------------------------*//
+
+/// ofxEasyOscAddress:
+
+/// OSC address with a fixed type signature, e.g. ofxEasyOscAddress<'f','f','f'> position("/position");
+/// Registering listeners with a typed address checks at compile time that the variable/argument type can be read from
+/// such a message and makes ofxEasyOscReceiver reject incoming messages with different type tags (see ofxEasyOscReceiver::setSignature()).
+
+template <char... Tags>
+class ofxEasyOscAddress {
+public:
+    ofxEasyOscAddress(const string& path_) : path(path_) {}
+    ofxEasyOscAddress(const char* path_) : path(path_) {}
+
+    const string& getPath() const { return path; }
+    // type tag string without the leading ','
+    static const char* getTypeTags() {
+        static const char tags[] = { Tags..., '\0' };
+        return tags;
+    }
+    static size_t getNumArgs() { return sizeof...(Tags); }
+
+protected:
+    string path;
+};
+
+
+//*----------------------------------------------------------------------------------------------------*//
+
+/// priority classes for ofxEasyOscReceiver::setPriority()
+
+enum ofxEasyOscPriority {
+    OFXEASYOSC_PRIORITY_HIGH,
+    OFXEASYOSC_PRIORITY_NORMAL,
+    OFXEASYOSC_PRIORITY_LOW,
+    OFXEASYOSC_NUM_PRIORITIES
+};
+
+/// what happens to the messages of a priority class when the receiver is overloaded (see ofxEasyOscReceiver::setBacklogThreshold())
+
+enum ofxEasyOscOverloadPolicy {
+    OFXEASYOSC_OVERLOAD_KEEP, // dispatch all messages
+    OFXEASYOSC_OVERLOAD_DROP, // drop all messages
+    OFXEASYOSC_OVERLOAD_COALESCE // only dispatch the latest message per address
+};
+
+
 //*----------------------------------------------------------------------------------------------------*//
 
 /// ofxEasyOscReceiver:
@@ -221,17 +1170,61 @@ inline void ofxEasyOscSender::fill(ofxOscMessage& msg){
 /// Every registered OSC message is also stored in a multi-set, so the user can see which messages (and how many of them) have actually arrived since the last call to update().
 /// You can write if statements with gotMessage(...) or ==(...) to do callback stuff if you don't like to register functions.
 /// It's also possible to get the whole set and search it with count().
+///
+/// Addresses can be assigned to priority classes (setPriority()). As soon as one is used, update() first reads all waiting datagrams
+/// and then dispatches the messages class by class (high, normal, low), each in arrival order. If more messages than the backlog threshold
+/// are waiting, the classes are shed from the lowest upwards according to their overload policy until the backlog fits
+/// (by default low priority messages are coalesced to the latest message per address, high priority messages are always kept).
+///
+/// Modules can own a receiver of their own and mount it under a prefix (mount()). Messages for "/synth/1/freq" are then looked up
+/// as "/freq" in the table of the child which is mounted at "/synth/1", so every table stays small. Listeners still see the full address.
+/// Disable a child (setEnabled(false)) to ignore its whole namespace.
+///
+/// Without a default listener (and without countIncomingMessages()) messages for unknown addresses can't go anywhere. They are
+/// dropped by a Bloom filter over the raw address bytes before the message is parsed, see setAddressFilter().
+///
+/// Datagrams with a sequence header (see ofxEasyOscSender::setSequenceNumbers()) are tracked per source, see getSequenceStats().
+/// Duplicates are discarded and late datagrams can be discarded as well (setLatePolicy()), so stale values don't overwrite newer ones.
+/// Reliable messages (see ofxEasyOscSender::setReliable()) are acknowledged to the sender and dispatched exactly once.
+/// Lost datagrams are rebuilt from parity packets if the sender uses forward error correction, see getFecStats().
+/// Delta encoded messages (see ofxEasyOscSender::setDelta()) are patched into the last keyframe of their source and dispatched in full
+/// (only for registered addresses, others just get the keyframes).
+/// A restarted receiver can ask a sender for its last-value table (see ofxEasyOscSender::setStateSync()), either with
+/// setAutoResync(true) when a sender is heard for the first time or with requestState(). The snapshot is applied directly to
+/// the registered variables and listeners (no priority queues, no default listener).
+/// With setSubscriptions(true) the receiver tells every sender which addresses it has registered (plus the patterns of subscribe()),
+/// so a sender with ofxEasyOscSender::setSubscriptionFilter(true) doesn't send anything else. A default listener subscribes to
+/// everything unless patterns are given.
+///
+/// The receiver doesn't run a listener thread. update() reads all datagrams which are waiting on the socket, so instead of
+/// polling you can block in waitForMessages() or add getFileDescriptor() to your own event loop (epoll, kqueue, select...)
+/// and only call update() when the socket becomes readable. wakeUp() interrupts waitForMessages() from another thread
+/// (in your own event loop add getWakeUpDescriptor() as well).
 
 class ofxEasyOscReceiver {
 public:
-    ofxEasyOscReceiver() : bCount(false), defaultListener(nullptr) {}
-    ofxEasyOscReceiver(int portNumber) : bCount(false), defaultListener(nullptr) { receiver.setup(portNumber); }
-	~ofxEasyOscReceiver() {}
+    ofxEasyOscReceiver() : defaultListener(nullptr), bCount(false), numRejected(0) { init(); }
+    ofxEasyOscReceiver(int portNumber) : defaultListener(nullptr), bCount(false), numRejected(0) { init(); setup(portNumber); }
+	~ofxEasyOscReceiver();
 	
-    void setup(int portNumber) { receiver.setup(portNumber);}
+    void setup(int portNumber);
 
     // update the receiver (look for waiting OSC messages, write the data into the variables and put the addresses into the multi-set)
     void update();
+
+    // check if there are OSC messages waiting (doesn't block)
+    bool hasWaitingMessages();
+    // block until OSC messages are waiting, wakeUp() is called or the timeout expires (negative = wait forever).
+    // returns true if there are messages waiting, so a headless service can simply do: while (true) { if (r.waitForMessages()) r.update(); }
+    bool waitForMessages(int timeoutMs = -1);
+    // interrupt waitForMessages() (thread-safe)
+    void wakeUp();
+    // native socket handle for external event loops. call update() whenever it becomes readable.
+    int getFileDescriptor() const;
+    // readable after wakeUp(), for external event loops. call clearWakeUp() when it has become readable.
+    // -1 on Windows, where wakeUp() makes the socket itself readable.
+    int getWakeUpDescriptor() const;
+    void clearWakeUp();
 	
 	// decide if you want to count incoming OSC messages
 	void countIncomingMessages(bool bUse);
@@ -243,8 +1236,24 @@ public:
     // get a multiset containing all addresses of messages that have arrived
     const unordered_multiset<string>& getIncomingMessages();
 
+    // recycled messages for listeners taking an ofxOscMessage (see ofxEasyOscMessagePool for statistics)
+    const ofxEasyOscMessagePool& getMessagePool() const { return messagePool; }
+
     /// The following types are allowed for variables, as arguments for functions and member function arguments:
-    /// bool, unsigned char, int, float, double, string, vector<bool>, vector<unsigned char>, vector<int>, vector<float>, vector<double>, vector<string>.
+    /// bool, unsigned char, int, long, long long, float, double, string, ofxEasyOscTimetag, ofVec2f, ofVec3f, ofVec4f, ofMatrix3x3, ofMatrix4x4,
+    /// std::bitset<N> and STL containers of these types (e.g. vector<float>, vector<double>, vector<string>, vector<ofVec3f>, vector<bool>).
+    /// Bools can be sent as numbers, as 'T'/'F' type tags or (for vector<bool> and std::bitset) as a bit-packed blob.
+    /// Containers of floats, vectors and matrices are also filled from a quantized blob (see ofxEasyOscQuantize()).
+    /// With C++17 functions and lambdas can also take a std::string_view, which points directly into the received packet
+    /// (don't keep it after the call and don't register string_view variables).
+    /// 64-bit arguments ('h', 'd', 't') are read without loss of precision if the destination is wide enough.
+    ///
+    /// With C++17 functions can also take std::pmr::string and std::pmr::vector<T> (of the types above). These arguments are allocated
+    /// from a bump arena which is reset at the end of update(), so they never touch the heap once the arena has grown large enough.
+    ///
+    /// Functions can also take the whole message: 'const ofxOscMessage&' is converted once per message and shared by all listeners
+    /// (take 'ofxOscMessage&' if you want a private copy you can modify), 'const ofxEasyOscMessageView&' is the received message
+    /// itself without any conversion (only valid during the call).
     ///
     /// Member functions are supposed to take one of these types as their *only* argument (with any qualifiers) and return either void or bool.
     /// They can belong to an object or to the app itself (pass the 'this' pointer).
@@ -262,6 +1271,15 @@ public:
     /// You can register more than one variable/member function for each address - your listeners will be stored in a list and notified in the same order
     /// you registered them. Method chaining is supported: e.g. myReceiver.add("/foo", &x).add("/bar", &y);
     ///
+    /// Every address can declare its type signature, either with a typed address (checked at compile time):
+    ///
+    /// ofxEasyOscAddress<'f','f','f'> position("/position");
+    /// add(position, &myVec3) ... compiles, while add(position, &myString) or add(position, &myVec2) don't.
+    ///
+    /// or at runtime with setSignature("/position", "fff"). Messages with different type tags are rejected by comparing a hash
+    /// which is computed while the message is parsed. Rejected messages are counted (see getNumRejectedMessages()) and reported
+    /// at most once per second per address. Types which can't be read at all (e.g. add("/foo", &someStruct)) never compile.
+    ///
     /// Finally you can also unregister listeners.
 
     /// Examples:
@@ -304,6 +1322,118 @@ public:
     template<typename TArg, typename TReturn, typename TObject>
     ofxEasyOscReceiver& add(const string& address, TObject* obj, TReturn(TObject::*func)(TArg));
 
+    /* register typed OSC addresses (same as above, but the listener is checked against the type signature) */
+
+    template<char... Tags>
+    ofxEasyOscReceiver& add(const ofxEasyOscAddress<Tags...>& address);
+
+    template<typename T, char... Tags>
+    ofxEasyOscReceiver& add(const ofxEasyOscAddress<Tags...>& address, T* var);
+
+    template<typename TReturn, char... Tags>
+    ofxEasyOscReceiver& add(const ofxEasyOscAddress<Tags...>& address, TReturn(*func)());
+
+    template<typename TArg, typename TReturn, char... Tags>
+    ofxEasyOscReceiver& add(const ofxEasyOscAddress<Tags...>& address, TReturn(*func)(TArg));
+
+    template<char... Tags>
+    ofxEasyOscReceiver& add(const ofxEasyOscAddress<Tags...>& address, const function<void()> & lambda);
+
+    template<typename TArg, char... Tags>
+    ofxEasyOscReceiver& add(const ofxEasyOscAddress<Tags...>& address, const function<void(TArg)> & lambda);
+
+    template<typename TReturn, typename TObject, char... Tags>
+    ofxEasyOscReceiver& add(const ofxEasyOscAddress<Tags...>& address, TObject* obj, TReturn(TObject::*func)());
+
+    template<typename TArg, typename TReturn, typename TObject, char... Tags>
+    ofxEasyOscReceiver& add(const ofxEasyOscAddress<Tags...>& address, TObject* obj, TReturn(TObject::*func)(TArg));
+
+    // declare the type signature of an address (type tags without the leading ',', e.g. "fff").
+    // messages with other type tags are rejected. an empty string accepts everything again.
+    ofxEasyOscReceiver& setSignature(const string& address, const string& typeTags);
+    ofxEasyOscReceiver& removeSignature(const string& address);
+
+    // number of messages which have been rejected because of a wrong type signature
+    uint64_t getNumRejectedMessages(const string& address) const;
+    uint64_t getNumRejectedMessages() const { return numRejected; }
+
+    // drop messages for unknown addresses before they are parsed (on by default, inactive while there is a default listener
+    // or the messages are counted). the filter is rebuilt lazily after addresses have been added or removed.
+    ofxEasyOscReceiver& setAddressFilter(bool bEnable) { bAddressFilter = bEnable; return *this; }
+    bool getAddressFilter() const { return bAddressFilter; }
+    // number of messages which have been dropped by the filter
+    uint64_t getNumFilteredMessages() const { return numFiltered; }
+
+    /* priority classes */
+
+    // assign a priority class to an address, e.g. add("/cue", this, &ofApp::cue).setPriority("/cue", OFXEASYOSC_PRIORITY_HIGH)
+    ofxEasyOscReceiver& setPriority(const string& address, ofxEasyOscPriority priority);
+    ofxEasyOscPriority getPriority(const string& address) const;
+    // priority of messages without a registered address (default: normal)
+    ofxEasyOscReceiver& setDefaultPriority(ofxEasyOscPriority priority);
+
+    // maximum number of messages dispatched per update() before classes are shed (0 = never shed)
+    ofxEasyOscReceiver& setBacklogThreshold(size_t numMessages);
+    size_t getBacklogThreshold() const { return backlogThreshold; }
+    // what happens to a class when the backlog threshold is exceeded
+    ofxEasyOscReceiver& setOverloadPolicy(ofxEasyOscPriority priority, ofxEasyOscOverloadPolicy policy);
+
+    // number of messages which have been shed (dropped or coalesced) per class
+    uint64_t getNumDroppedMessages(ofxEasyOscPriority priority) const { return numDropped[priority]; }
+
+    /* sequence numbers */
+
+    // what happens to datagrams which arrive after a newer one from the same sender (default: dispatch)
+    ofxEasyOscReceiver& setLatePolicy(ofxEasyOscLatePolicy policy) { latePolicy = policy; return *this; }
+    ofxEasyOscLatePolicy getLatePolicy() const { return latePolicy; }
+
+    // totals of all sources (can be called from any thread)
+    ofxEasyOscSequenceStats getSequenceStats() const { return sequenceTracker.getStats(); }
+    // statistics of a single sender
+    ofxEasyOscSequenceStats getSequenceStats(const ofxEasyOscEndpoint& source) const { return sequenceTracker.getStats(source); }
+    // duplicated, reordered and discarded messages of a registered address. losses are only known per source, a lost
+    // datagram can't be attributed to an address. can be called from any thread while no listeners are added or removed.
+    ofxEasyOscSequenceStats getSequenceStats(const string& address) const;
+    // all senders which have sent sequence numbers
+    const ofxEasyOscSequenceTracker& getSequenceTracker() const { return sequenceTracker; }
+    // reliable messages which have been received (including duplicates) and acknowledged
+    const ofxEasyOscReliableStats& getReliableStats() const { return reliableTracker.getStats(); }
+    // datagrams which have been recovered with forward error correction
+    const ofxEasyOscFecStats& getFecStats() const { return fecDecoder.getStats(); }
+    // compressed envelopes which have been unpacked (see ofxEasyOscSender::setCompression())
+    const ofxEasyOscCompressionStats& getCompressionStats() const { return compressionStats; }
+    // delta encoded messages which have been patched or couldn't be applied (see ofxEasyOscSender::setDelta())
+    const ofxEasyOscDeltaStats& getDeltaStats() const { return deltaDecoder.getStats(); }
+
+    /* state snapshots */
+
+    // ask every sender for its state when it is heard for the first time
+    ofxEasyOscReceiver& setAutoResync(bool bEnable) { bAutoResync = bEnable; return *this; }
+    bool getAutoResync() const { return bAutoResync; }
+    // ask a sender (e.g. ofxEasyOscMessageView::getRemoteEndpoint()) for its state
+    ofxEasyOscReceiver& requestState(const ofxEasyOscEndpoint& source);
+    // forget the senders, so they are asked again (e.g. after the listeners have been reset)
+    ofxEasyOscReceiver& resetResync() { resyncSources.clear(); return *this; }
+    const ofxEasyOscStateStats& getStateStats() const { return stateStats; }
+
+    /* subscriptions */
+
+    // announce the registered addresses to every sender (when it is heard for the first time, after changes and every 'refreshInterval' seconds)
+    ofxEasyOscReceiver& setSubscriptions(bool bEnable, double refreshInterval = 2);
+    bool getSubscriptions() const { return bSubscriptions; }
+    // subscribe to additional addresses: an exact address, a prefix ending with '*' ("/debug/*") or "*" for everything
+    ofxEasyOscReceiver& subscribe(const string& pattern);
+    ofxEasyOscReceiver& unsubscribe(const string& pattern);
+    const ofxEasyOscSubscriptionStats& getSubscriptionStats() const { return subscriptionStats; }
+
+    /* testing */
+
+    // simulate a bad network for incoming datagrams (and outgoing acknowledgements), see ofxEasyOscImpairment.
+    // delayed datagrams are only dispatched by update(), an external event loop isn't woken up for them.
+    ofxEasyOscReceiver& setImpairment(const ofxEasyOscImpairment& impairment) { socket.setImpairment(impairment); return *this; }
+    ofxEasyOscReceiver& removeImpairment() { socket.removeImpairment(); return *this; }
+    const ofxEasyOscImpairmentStats& getImpairmentStats() const { return socket.getImpairmentStats(); }
+
 	
     /* unregister OSC addresses*/
 
@@ -344,18 +1474,173 @@ public:
 	template <typename TObject>
     ofxEasyOscReceiver& setDefaultListener(TObject* obj, void (TObject::*func)(const ofxOscMessage&));
 
+    // same as above, but without converting the message (the view is only valid during the call)
+    ofxEasyOscReceiver& setDefaultListener(void (*func)(const ofxEasyOscMessageView&));
+
+    ofxEasyOscReceiver& setDefaultListener(const function<void(const ofxEasyOscMessageView&)>& lambda);
+
+    template <typename TObject>
+    ofxEasyOscReceiver& setDefaultListener(TObject* obj, void (TObject::*func)(const ofxEasyOscMessageView&));
+
 	/* remove default listener */
 	ofxEasyOscReceiver& removeDefaultListener();
+
+    /* namespaces */
+
+    // dispatch messages below 'prefix' (e.g. "/synth/1") to the child, which registers its addresses without the prefix ("/freq").
+    // the child doesn't need a port and isn't updated itself. a child can only be mounted once.
+    ofxEasyOscReceiver& mount(const string& prefix, ofxEasyOscReceiver* child);
+    ofxEasyOscReceiver& unmount(const string& prefix);
+    // a disabled receiver ignores all messages (a mounted child its whole namespace)
+    ofxEasyOscReceiver& setEnabled(bool bEnable);
+    bool isEnabled() const { return bEnabled; }
 	
 protected:
+    void init();
+    list<unique_ptr<ofxOscListener>>& getListeners(const string& address);
     void searchAndRemove(const string& address, ofxOscListener* testobj);
     void searchAndRemoveLambdas(const string& address);
 
-    unordered_map<string, list<unique_ptr<ofxOscListener>>> addressMap;
+    // parse a datagram (message or bundle) and dispatch the contained messages
+    void processPacket(const char* data, size_t size, const ofxEasyOscEndpoint& from, bool bQueue = false);
+    // 'offset' is the length of the prefix of a mounted receiver
+    void dispatch(const ofxEasyOscMessageView& msg, size_t offset = 0);
+
+    struct AddressEntry {
+        AddressEntry() : bRegistered(false), bTyped(false), typeTagHash(0), numRejected(0), numUnreported(0),
+            priority(OFXEASYOSC_PRIORITY_NORMAL), latest(0) {}
+        // registered with add() (otherwise messages go to the default listener)
+        bool bRegistered;
+        list<unique_ptr<ofxOscListener>> listeners;
+        // type signature (see setSignature())
+        bool bTyped;
+        string typeTags;
+        uint32_t typeTagHash;
+        // rejected messages (reported at most once per second)
+        uint64_t numRejected;
+        uint64_t numUnreported;
+        chrono::steady_clock::time_point lastReport;
+        // priority class
+        ofxEasyOscPriority priority;
+        // index of the latest queued message (for coalescing)
+        size_t latest;
+        // duplicated/reordered messages
+        ofxEasyOscSequenceCounters sequenceStats;
+    };
+
+    // message waiting in a priority queue
+    struct QueuedMessage {
+        size_t offset; // in backlog
+        size_t size;
+        ofxEasyOscEndpoint from;
+        AddressEntry* entry; // only valid until the queues are dispatched
+    };
+
+    // queue a message instead of dispatching it directly
+    void enqueue(const ofxEasyOscMessageView& msg);
+    // shed classes if necessary and dispatch the queues
+    void dispatchQueues();
+
+    // compile time check of the listener's argument type (decayed) against the type signature
+    template <typename TArg, char... Tags>
+    AddressEntry& declare(const ofxEasyOscAddress<Tags...>& address);
+    void reject(AddressEntry& entry, const ofxEasyOscMessageView& msg);
+    // dispatch the contents of a compressed envelope. returns false if 'msg' isn't one.
+    bool decompress(const ofxEasyOscMessageView& msg, bool bQueue);
+    // keyframe headers and delta messages. returns true if the message has been consumed.
+    // 'frame' and 'bKeyframe' carry the keyframe header over to the next message of the packet.
+    bool handleDelta(const ofxEasyOscMessageView& msg, bool bQueue, uint32_t& frame, bool& bKeyframe);
+    // the address (below the mount point) has listeners
+    bool isRegistered(const char* address, size_t length);
+    // apply a message of a state snapshot
+    void applyState(const ofxEasyOscMessageView& msg, size_t offset = 0);
+    // returns true if the raw message is surely not for a known address
+    bool isFiltered(const char* data, size_t size);
+    // returns false if the address (below the mount point) is surely unknown
+    bool mayAccept(const char* address, size_t length);
+    // the child whose namespace contains the address
+    struct Mount {
+        string prefix;
+        ofxEasyOscReceiver* receiver;
+    };
+    const Mount* findMount(const char* address, size_t length) const {
+        return mounts.empty() ? nullptr : resolveMount(address, length);
+    }
+    const Mount* resolveMount(const char* address, size_t length) const;
+    void indexMounts();
+    // mounted children aren't updated themselves: clear their message counts and free their arenas with ours
+    void beginUpdate();
+    void endUpdate();
+    // registered addresses and patterns, including the children (with their prefixes)
+    void collectSubscriptions(const string& prefix, vector<string>& patterns) const;
+    // also tells the parents
+    void setSubscriptionsDirty();
+    // send the subscriptions to a sender (or to all of them)
+    void announce(const ofxEasyOscEndpoint& to);
+    void announce();
+    // returns false if the message of a duplicated or late datagram must be discarded
+    bool checkSequence(const ofxEasyOscMessageView& msg, ofxEasyOscSequenceResult result);
+
+    unordered_map<string, AddressEntry> addressMap;
 	unique_ptr<ofxOscListener> defaultListener;
-    ofxOscReceiver receiver;
+    ofxEasyOscMessagePool messagePool;
+    string addressKey;
+    ofxEasyOscImpairedSocket socket;
+    vector<char> buffer;
     unordered_multiset<string> incomingMessages;
     bool bCount;
+    uint64_t numRejected;
+    // address pre-filter
+    ofxEasyOscAddressFilter addressFilter;
+    bool bAddressFilter;
+    bool bAddressFilterDirty;
+    uint64_t numFiltered;
+    // priority classes
+    bool bPriorities;
+    ofxEasyOscPriority defaultPriority;
+    size_t backlogThreshold;
+    ofxEasyOscOverloadPolicy overloadPolicy[OFXEASYOSC_NUM_PRIORITIES];
+    uint64_t numDropped[OFXEASYOSC_NUM_PRIORITIES];
+    vector<QueuedMessage> queues[OFXEASYOSC_NUM_PRIORITIES];
+    vector<char> backlog;
+    // sequence numbers
+    ofxEasyOscSequenceTracker sequenceTracker;
+    ofxEasyOscLatePolicy latePolicy;
+    // reliable delivery
+    ofxEasyOscReliableTracker reliableTracker;
+    // forward error correction
+    ofxEasyOscFecDecoder fecDecoder;
+    // compression
+    vector<char> inflated;
+    bool bInflating;
+    ofxEasyOscCompressionStats compressionStats;
+    // delta encoding
+    ofxEasyOscDeltaDecoder deltaDecoder;
+    vector<char> patched;
+    bool bPatching;
+    // state snapshots
+    bool bAutoResync;
+    vector<ofxEasyOscEndpoint> resyncSources; // senders which have been asked
+    ofxEasyOscStateStats stateStats;
+    // subscriptions
+    bool bSubscriptions;
+    bool bSubscriptionsDirty;
+    bool bSubscribedAll; // the default listener was set at the last announcement
+    int64_t subscriptionInterval;
+    int64_t lastAnnouncement;
+    uint32_t subscriptionGeneration;
+    vector<string> subscriptionPatterns;
+    vector<string> announcement;
+    vector<ofxEasyOscEndpoint> subscriptionSources; // senders which have got an announcement
+    ofxEasyOscWriter subscriptionWriter;
+    ofxEasyOscSubscriptionStats subscriptionStats;
+    // namespaces
+    bool bEnabled;
+    ofxEasyOscReceiver* parent;
+    vector<Mount> mounts;
+    // hashes of the prefixes (same order as 'mounts') and the distinct prefix lengths (longest first)
+    vector<uint64_t> mountHashes;
+    vector<size_t> mountLengths;
 };
 
 
@@ -363,33 +1648,641 @@ protected:
 /* definitions */
 
 
+inline void ofxEasyOscReceiver::init(){
+    bInflating = false;
+    bPatching = false;
+    bAutoResync = false;
+    bEnabled = true;
+    parent = nullptr;
+    bAddressFilter = true;
+    bAddressFilterDirty = true;
+    numFiltered = 0;
+    bSubscriptions = false;
+    bSubscriptionsDirty = false;
+    bSubscribedAll = false;
+    subscriptionInterval = 0;
+    lastAnnouncement = 0;
+    subscriptionGeneration = 0;
+    latePolicy = OFXEASYOSC_LATE_DISPATCH;
+    bPriorities = false;
+    defaultPriority = OFXEASYOSC_PRIORITY_NORMAL;
+    backlogThreshold = 0;
+    overloadPolicy[OFXEASYOSC_PRIORITY_HIGH] = OFXEASYOSC_OVERLOAD_KEEP;
+    overloadPolicy[OFXEASYOSC_PRIORITY_NORMAL] = OFXEASYOSC_OVERLOAD_KEEP;
+    overloadPolicy[OFXEASYOSC_PRIORITY_LOW] = OFXEASYOSC_OVERLOAD_COALESCE;
+    for (int i = 0; i < OFXEASYOSC_NUM_PRIORITIES; ++i){
+        numDropped[i] = 0;
+    }
+}
+
+inline ofxEasyOscReceiver::~ofxEasyOscReceiver(){
+    // don't leave dangling pointers behind
+    if (parent){
+        for (auto it = parent->mounts.begin(); it != parent->mounts.end(); ++it){
+            if (it->receiver == this){
+                parent->mounts.erase(it);
+                parent->indexMounts();
+                break;
+            }
+        }
+        parent->setSubscriptionsDirty();
+    }
+    for (auto& mount : mounts){
+        mount.receiver->parent = nullptr;
+    }
+}
+
+inline void ofxEasyOscReceiver::setup(int portNumber){
+    if (!socket.bind(portNumber)){
+        ofLogError("ofxEasyOscReceiver") << "couldn't bind to port " << portNumber;
+    }
+    // big enough for any UDP datagram
+    buffer.resize(65536);
+}
+
 // update the receiver (look for waiting OSC messages, write the data into the variables and put the addresses into the multi-set)
 inline void ofxEasyOscReceiver::update(){
+    beginUpdate();
+
+    // priority queues (not if we're called from a listener while the queues are dispatched)
+    const bool bQueue = bPriorities && !messagePool.isDispatching();
+
+    ofxEasyOscEndpoint from;
+    int size;
+    while ((size = socket.receive(buffer.data(), buffer.size(), &from)) > 0) {
+        if (bAutoResync && std::find(resyncSources.begin(), resyncSources.end(), from) == resyncSources.end()){
+            requestState(from);
+        }
+        if (bSubscriptions && std::find(subscriptionSources.begin(), subscriptionSources.end(), from) == subscriptionSources.end()){
+            subscriptionSources.push_back(from);
+            announce(from);
+        }
+        // unwrap FEC datagrams and process the recovered ones
+        if (!fecDecoder.decode(buffer.data(), size, from, [&](const char* data, size_t n){
+            processPacket(data, n, from, bQueue);
+        })){
+            processPacket(buffer.data(), size, from, bQueue);
+        }
+    }
+    if (bQueue){
+        dispatchQueues();
+    }
+    if (bSubscriptions && !subscriptionSources.empty()){
+        // listeners might have been added or removed, and announcements can get lost
+        if (bSubscriptionsDirty || bSubscribedAll != (defaultListener != nullptr)
+                || ofxEasyOscRateLimiter::now() - lastAnnouncement >= subscriptionInterval){
+            announce();
+        }
+    }
+    // delayed acknowledgements
+    if (socket.isImpaired()){
+        socket.flush();
+    }
+    endUpdate();
+}
+
+inline void ofxEasyOscReceiver::beginUpdate(){
     incomingMessages.clear();
+    for (auto& mount : mounts){
+        mount.receiver->beginUpdate();
+    }
+}
+
+inline void ofxEasyOscReceiver::endUpdate(){
+#ifdef OFXEASYOSC_HAS_PMR
+    // free the temporary pmr arguments (unless we're called from a listener)
+    if (!messagePool.isDispatching()){
+        messagePool.getArena().reset();
+    }
+#endif
+    for (auto& mount : mounts){
+        mount.receiver->endUpdate();
+    }
+}
+
+// check if there are OSC messages waiting (doesn't block)
+inline bool ofxEasyOscReceiver::hasWaitingMessages(){
+    return socket.wait(0);
+}
+
+// block until OSC messages are waiting, wakeUp() is called or the timeout expires
+inline bool ofxEasyOscReceiver::waitForMessages(int timeoutMs){
+    return socket.wait(timeoutMs);
+}
+
+// interrupt waitForMessages()
+inline void ofxEasyOscReceiver::wakeUp(){
+    socket.wakeUp();
+}
+
+// native socket handle for external event loops
+inline int ofxEasyOscReceiver::getFileDescriptor() const {
+    return socket.getFileDescriptor();
+}
+
+inline int ofxEasyOscReceiver::getWakeUpDescriptor() const {
+    return socket.getWakeUpDescriptor();
+}
+
+inline void ofxEasyOscReceiver::clearWakeUp(){
+    socket.clearWakeUp();
+}
+
+// bundles are unpacked recursively
+inline void ofxEasyOscReceiver::processPacket(const char* data, size_t size, const ofxEasyOscEndpoint& from, bool bQueue){
+    ofxEasyOscMessageView msg;
+    msg.setRemoteEndpoint(from);
+    // the sequence header is the first element of the bundle and applies to the rest of the datagram
+    bool bSequence = false;
+    ofxEasyOscSequenceResult sequenceResult = OFXEASYOSC_SEQUENCE_IN_ORDER;
+    uint32_t frame = 0;
+    bool bKeyframe = false;
+    // the rest of a state bundle is applied directly
+    bool bState = false;
+    bool ok = ofxEasyOscParsePacket(data, size, [&](const char* msgData, size_t msgSize){
+        // the keyframe after a "/#k" header must reach the delta decoder
+        if (!bKeyframe && isFiltered(msgData, msgSize)){
+            return;
+        }
+        if (msg.parse(msgData, msgSize)){
+            msg.setRemoteEndpoint(from);
+            uint32_t stream, sequence, base;
+            if (!bSequence && ofxEasyOscSequenceHeader::read(msg, stream, sequence)){
+                bSequence = true;
+                sequenceResult = sequenceTracker.track(from, stream, sequence);
+                if (sequenceResult == OFXEASYOSC_SEQUENCE_LATE && latePolicy == OFXEASYOSC_LATE_DISCARD){
+                    sequenceTracker.discard(from);
+                }
+                return;
+            }
+            if (!bSequence && ofxEasyOscReliableTracker::read(msg, stream, sequence, base)){
+                bSequence = true;
+                // reliable messages are never late, only duplicated (retransmitted after the acknowledgement got lost)
+                if (!reliableTracker.track(from, stream, sequence, base, [&](const char* ack, size_t ackSize){
+                    socket.sendTo(ack, ackSize, from);
+                })){
+                    sequenceResult = OFXEASYOSC_SEQUENCE_DUPLICATE;
+                }
+                return;
+            }
+            if (bSequence && !checkSequence(msg, sequenceResult)){
+                return;
+            }
+            if (bState){
+                applyState(msg);
+                return;
+            }
+            uint32_t part, numParts;
+            if (ofxEasyOscStateTable::readHeader(msg, part, numParts)){
+                bState = true;
+                ++stateStats.numBundles;
+                if (part + 1 == numParts){
+                    ++stateStats.numSnapshots;
+                }
+                return;
+            }
+            if (ofxEasyOscCompressor::isProbe(msg)){
+                // tell the sender that we understand compressed envelopes
+                char probe[ofxEasyOscCompressor::probeSize];
+                ofxEasyOscCompressor::writeProbe(probe);
+                socket.sendTo(probe, sizeof(probe), from);
+                return;
+            }
+            if (handleDelta(msg, bQueue, frame, bKeyframe)){
+                return;
+            }
+            if (msg.getAddressLength() == 3 && msg.getAddressData()[1] == '#' && decompress(msg, bQueue)){
+                return;
+            }
+            if (bQueue){
+                enqueue(msg);
+            } else {
+                dispatch(msg);
+            }
+        } else {
+            ofLogError("ofxEasyOscReceiver") << "malformed OSC message from " << from.getHost();
+        }
+    });
+    if (!ok){
+        ofLogError("ofxEasyOscReceiver") << "malformed OSC packet from " << from.getHost();
+    }
+}
+
+inline void ofxEasyOscReceiver::enqueue(const ofxEasyOscMessageView& msg){
+    addressKey.assign(msg.getAddressData(), msg.getAddressLength());
+    auto it = addressMap.find(addressKey);
+    AddressEntry* entry = (it != addressMap.end()) ? &it->second : nullptr;
+    const ofxEasyOscPriority priority = entry ? entry->priority : defaultPriority;
+
+    QueuedMessage queued;
+    queued.offset = backlog.size();
+    queued.size = msg.getSize();
+    queued.from = msg.getRemoteEndpoint();
+    queued.entry = entry;
+    // copy the message, the receive buffer is reused for the next datagram
+    backlog.insert(backlog.end(), msg.getData(), msg.getData() + msg.getSize());
+    if (entry){
+        entry->latest = queues[priority].size();
+    }
+    queues[priority].push_back(queued);
+}
+
+inline void ofxEasyOscReceiver::dispatchQueues(){
+    size_t total = 0;
+    for (int i = 0; i < OFXEASYOSC_NUM_PRIORITIES; ++i){
+        total += queues[i].size();
+    }
+    // shed from the lowest class upwards until the backlog fits
+    for (int i = OFXEASYOSC_NUM_PRIORITIES - 1; i >= 0 && backlogThreshold && total > backlogThreshold; --i){
+        auto & queue = queues[i];
+        const size_t before = queue.size();
+        if (overloadPolicy[i] == OFXEASYOSC_OVERLOAD_DROP){
+            queue.clear();
+        } else if (overloadPolicy[i] == OFXEASYOSC_OVERLOAD_COALESCE){
+            // keep the latest message per address (unregistered addresses can't be coalesced)
+            size_t n = 0;
+            for (size_t k = 0; k < queue.size(); ++k){
+                if (!queue[k].entry || queue[k].entry->latest == k){
+                    queue[n++] = queue[k];
+                }
+            }
+            queue.resize(n);
+        }
+        numDropped[i] += before - queue.size();
+        total -= before - queue.size();
+    }
+    // dispatch class by class
+    ofxEasyOscMessageView msg;
+    for (int i = 0; i < OFXEASYOSC_NUM_PRIORITIES; ++i){
+        for (auto & queued : queues[i]){
+            if (msg.parse(backlog.data() + queued.offset, queued.size)){
+                msg.setRemoteEndpoint(queued.from);
+                dispatch(msg);
+            }
+        }
+        queues[i].clear();
+    }
+    backlog.clear();
+}
+
+inline void ofxEasyOscReceiver::dispatch(const ofxEasyOscMessageView& msg, size_t offset){
+    if (!bEnabled){
+        return;
+    }
+    const char* path = msg.getAddressData() + offset;
+    const size_t length = msg.getAddressLength() - offset;
+    // the namespace of a child is resolved once, the child only looks up the rest
+    if (const Mount* mount = findMount(path, length)){
+        mount->receiver->dispatch(msg, offset + mount->prefix.size());
+        return;
+    }
+    // reuse the capacity of the lookup key
+    string& address = addressKey;
+    address.assign(path, length);
+    auto it = addressMap.find(address);
+
+    if (it != addressMap.end()) {
+        auto & entry = it->second;
+        // O(1) type check: the hash was computed while parsing
+        if (entry.bTyped && (msg.getTypeTagHash() != entry.typeTagHash || msg.getTypeTagsLength() != entry.typeTags.size())){
+            reject(entry, msg);
+            return;
+        }
+    }
+
+    if (bCount){
+        // add address to multi-set (before the listeners, which might call update() again and reuse the key)
+        incomingMessages.insert(address);
+    }
+
+    // listeners taking an ofxOscMessage share a single conversion
+    ofxEasyOscMessagePool::Scope scope(messagePool, msg);
+    if (it != addressMap.end() && it->second.bRegistered) {
+        // pass OSC message to the list of listener objects
+        auto & listeners = it->second.listeners;
+        for (auto it = listeners.begin(); it != listeners.end(); ++it){
+            (*it)->dispatch(msg, messagePool);
+        }
+    } else {
+        // pass OSC message to default listener (if it has been set)
+        if (defaultListener){
+            defaultListener->dispatch(msg, messagePool);
+        }
+    }
+}
+
+inline bool ofxEasyOscReceiver::decompress(const ofxEasyOscMessageView& msg, bool bQueue){
+    // a listener might call update() while we're still walking the buffer
+    vector<char> temp;
+    vector<char>& buffer = bInflating ? temp : inflated;
+    size_t size;
+    if (!ofxEasyOscCompressor::decompress(msg, buffer, size)){
+        return false;
+    }
+    const ofxEasyOscEndpoint& from = msg.getRemoteEndpoint();
+    if (!size){
+        ++compressionStats.numErrors;
+        ofLogError("ofxEasyOscReceiver") << "malformed compressed packet from " << from.getHost();
+        return true;
+    }
+    ++compressionStats.numDecompressed;
+    const bool bWasInflating = bInflating;
+    bInflating = true;
+    // the envelope contains a plain message or bundle (e.g. a keyframe)
+    ofxEasyOscMessageView inner;
+    uint32_t frame = 0;
+    bool bKeyframe = false;
+    bool ok = ofxEasyOscParsePacket(buffer.data(), size, [&](const char* data, size_t n){
+        if (!bKeyframe && isFiltered(data, n)){
+            return;
+        }
+        if (inner.parse(data, n)){
+            inner.setRemoteEndpoint(from);
+            if (handleDelta(inner, bQueue, frame, bKeyframe)){
+                return;
+            }
+            if (bQueue){
+                enqueue(inner);
+            } else {
+                dispatch(inner);
+            }
+        }
+    });
+    bInflating = bWasInflating;
+    if (!ok){
+        ++compressionStats.numErrors;
+        ofLogError("ofxEasyOscReceiver") << "malformed compressed packet from " << from.getHost();
+    }
+    return true;
+}
 
-    while (receiver.hasWaitingMessages()) {
-        ofxOscMessage msg;
-        receiver.getNextMessage(msg);
-        const string address = msg.getAddress();
-        auto it = addressMap.find(address);
-
-        if (it != addressMap.end()) {
-            // pass OSC message to the list of listener objects
-            auto & listeners = it->second;
-            for (auto it = listeners.begin(); it != listeners.end(); ++it){
-                (*it)->dispatch(msg);
-            }           
+inline bool ofxEasyOscReceiver::handleDelta(const ofxEasyOscMessageView& msg, bool bQueue, uint32_t& frame, bool& bKeyframe){
+    if (bKeyframe){
+        // the message after the header is the keyframe. it's dispatched as usual, but only registered addresses get a base.
+        bKeyframe = false;
+        if (isRegistered(msg.getAddressData(), msg.getAddressLength())){
+            deltaDecoder.keyframe(msg, frame);
+        }
+        return false;
+    }
+    if (!(msg.getAddressLength() == 3 && msg.getAddressData()[1] == '#')){
+        return false;
+    }
+    if (ofxEasyOscDeltaDecoder::readKeyframe(msg, frame)){
+        bKeyframe = true;
+        return true;
+    }
+    // a listener might call update() while we're still dispatching the patched message
+    vector<char> temp;
+    vector<char>& buffer = bPatching ? temp : patched;
+    size_t size;
+    if (!deltaDecoder.patch(msg, buffer, size)){
+        return false;
+    }
+    ofxEasyOscMessageView full;
+    if (size && full.parse(buffer.data(), size)){
+        full.setRemoteEndpoint(msg.getRemoteEndpoint());
+        const bool bWasPatching = bPatching;
+        bPatching = true;
+        if (bQueue){
+            enqueue(full);
         } else {
-			// pass OSC message to default listener (if it has been set)
-			if (defaultListener){
-				defaultListener->dispatch(msg);
-			}
-		}
-		
-		if (bCount){
-			// add address to multi-set
-            incomingMessages.insert(address);
-		}
+            dispatch(full);
+        }
+        bPatching = bWasPatching;
+    }
+    return true;
+}
+
+inline bool ofxEasyOscReceiver::isRegistered(const char* address, size_t length){
+    if (const Mount* mount = findMount(address, length)){
+        return mount->receiver->isRegistered(address + mount->prefix.size(), length - mount->prefix.size());
+    }
+    addressKey.assign(address, length);
+    auto it = addressMap.find(addressKey);
+    return it != addressMap.end() && it->second.bRegistered;
+}
+
+inline ofxEasyOscReceiver& ofxEasyOscReceiver::requestState(const ofxEasyOscEndpoint& source){
+    if (std::find(resyncSources.begin(), resyncSources.end(), source) == resyncSources.end()){
+        resyncSources.push_back(source);
+    }
+    char request[ofxEasyOscStateTable::requestSize];
+    ofxEasyOscStateTable::writeRequest(request);
+    socket.sendTo(request, sizeof(request), source);
+    return *this;
+}
+
+inline ofxEasyOscReceiver& ofxEasyOscReceiver::setSubscriptions(bool bEnable, double refreshInterval){
+    bSubscriptions = bEnable;
+    subscriptionInterval = static_cast<int64_t>(refreshInterval * 1e9);
+    subscriptionSources.clear();
+    return *this;
+}
+
+inline ofxEasyOscReceiver& ofxEasyOscReceiver::subscribe(const string& pattern){
+    if (std::find(subscriptionPatterns.begin(), subscriptionPatterns.end(), pattern) == subscriptionPatterns.end()){
+        subscriptionPatterns.push_back(pattern);
+        setSubscriptionsDirty();
+    }
+    return *this;
+}
+
+inline ofxEasyOscReceiver& ofxEasyOscReceiver::unsubscribe(const string& pattern){
+    auto it = std::find(subscriptionPatterns.begin(), subscriptionPatterns.end(), pattern);
+    if (it != subscriptionPatterns.end()){
+        subscriptionPatterns.erase(it);
+        setSubscriptionsDirty();
+    }
+    return *this;
+}
+
+inline void ofxEasyOscReceiver::announce(const ofxEasyOscEndpoint& to){
+    if (bSubscriptionsDirty || announcement.empty()){
+        announcement.clear();
+        collectSubscriptions("", announcement);
+        bSubscribedAll = defaultListener != nullptr;
+        // an empty announcement would be ignored
+        if (announcement.empty()){
+            announcement.push_back("");
+        }
+        ++subscriptionGeneration;
+        bSubscriptionsDirty = false;
+    }
+    ofxEasyOscSubscriptionFilter::announce(announcement, subscriptionGeneration, 1400, subscriptionWriter,
+                                           [&](const char* data, size_t size){
+        socket.sendTo(data, size, to);
+    });
+    ++subscriptionStats.numAnnouncements;
+}
+
+inline void ofxEasyOscReceiver::collectSubscriptions(const string& prefix, vector<string>& patterns) const {
+    if (!bEnabled){
+        return;
+    }
+    for (auto& entry : addressMap){
+        if (entry.second.bRegistered){
+            patterns.push_back(prefix + entry.first);
+        }
+    }
+    for (auto& pattern : subscriptionPatterns){
+        // "*" only covers the namespace of a child
+        patterns.push_back(prefix.empty() || pattern != "*" ? prefix + pattern : prefix + "/*");
+    }
+    if (defaultListener && subscriptionPatterns.empty()){
+        patterns.push_back(prefix.empty() ? "*" : prefix + "/*");
+    }
+    for (auto& mount : mounts){
+        mount.receiver->collectSubscriptions(prefix + mount.prefix, patterns);
+    }
+}
+
+inline void ofxEasyOscReceiver::setSubscriptionsDirty(){
+    for (ofxEasyOscReceiver* receiver = this; receiver; receiver = receiver->parent){
+        receiver->bSubscriptionsDirty = true;
+    }
+}
+
+inline void ofxEasyOscReceiver::announce(){
+    if (bSubscribedAll != (defaultListener != nullptr)){
+        bSubscriptionsDirty = true;
+    }
+    for (auto& source : subscriptionSources){
+        announce(source);
+    }
+    lastAnnouncement = ofxEasyOscRateLimiter::now();
+}
+
+inline void ofxEasyOscReceiver::applyState(const ofxEasyOscMessageView& msg, size_t offset){
+    if (!bEnabled){
+        return;
+    }
+    const char* path = msg.getAddressData() + offset;
+    const size_t length = msg.getAddressLength() - offset;
+    if (const Mount* mount = findMount(path, length)){
+        mount->receiver->applyState(msg, offset + mount->prefix.size());
+        return;
+    }
+    // only registered addresses, without counting, queueing or the default listener
+    addressKey.assign(path, length);
+    auto it = addressMap.find(addressKey);
+    if (it == addressMap.end() || !it->second.bRegistered){
+        return;
+    }
+    auto & entry = it->second;
+    if (entry.bTyped && (msg.getTypeTagHash() != entry.typeTagHash || msg.getTypeTagsLength() != entry.typeTags.size())){
+        reject(entry, msg);
+        return;
+    }
+    ++stateStats.numApplied;
+    ofxEasyOscMessagePool::Scope scope(messagePool, msg);
+    for (auto& listener : entry.listeners){
+        listener->dispatch(msg, messagePool);
+    }
+}
+
+inline bool ofxEasyOscReceiver::isFiltered(const char* data, size_t size){
+    if (!bAddressFilter || defaultListener || bCount){
+        return false;
+    }
+    const char* end = static_cast<const char*>(std::memchr(data, 0, size));
+    // let the parser complain about malformed messages, control messages are handled before the dispatch
+    if (!end || (end - data == 3 && data[1] == '#') || mayAccept(data, end - data)){
+        return false;
+    }
+    ++numFiltered;
+    return true;
+}
+
+inline bool ofxEasyOscReceiver::mayAccept(const char* address, size_t length){
+    if (!bEnabled){
+        return false;
+    }
+    // the namespace of a child belongs to the child (like in dispatch()), which has a filter of its own
+    if (const Mount* mount = findMount(address, length)){
+        return mount->receiver->mayAccept(address + mount->prefix.size(), length - mount->prefix.size());
+    }
+    if (!bAddressFilter || defaultListener || bCount){
+        return true;
+    }
+    if (bAddressFilterDirty){
+        // also entries without listeners (e.g. type signatures, which count rejected messages)
+        addressFilter.reset(addressMap.size());
+        for (auto& entry : addressMap){
+            addressFilter.insert(entry.first);
+        }
+        bAddressFilterDirty = false;
+    }
+    return addressFilter.mayContain(address, length);
+}
+
+inline const ofxEasyOscReceiver::Mount* ofxEasyOscReceiver::resolveMount(const char* address, size_t length) const {
+    for (size_t n : mountLengths){
+        if (length > n && address[n] == '/'){
+            // one hash per length, the scan only compares integers
+            const uint64_t h = ofxEasyOscAddressFilter::hash(address, n);
+            for (size_t i = 0; i < mountHashes.size(); ++i){
+                const Mount& mount = mounts[i];
+                if (mountHashes[i] == h && mount.prefix.size() == n && std::memcmp(address, mount.prefix.data(), n) == 0){
+                    return &mount;
+                }
+            }
+        }
+    }
+    return nullptr;
+}
+
+inline void ofxEasyOscReceiver::indexMounts(){
+    mountHashes.clear();
+    mountLengths.clear();
+    for (size_t i = 0; i < mounts.size(); ++i){
+        const string& prefix = mounts[i].prefix;
+        mountHashes.push_back(ofxEasyOscAddressFilter::hash(prefix.data(), prefix.size()));
+        if (std::find(mountLengths.begin(), mountLengths.end(), prefix.size()) == mountLengths.end()){
+            mountLengths.push_back(prefix.size());
+        }
+    }
+    // nested mount points win
+    std::sort(mountLengths.begin(), mountLengths.end(), std::greater<size_t>());
+}
+
+inline bool ofxEasyOscReceiver::checkSequence(const ofxEasyOscMessageView& msg, ofxEasyOscSequenceResult result){
+    // the common case doesn't need another lookup
+    if (result == OFXEASYOSC_SEQUENCE_IN_ORDER){
+        return true;
+    }
+    const bool bDiscard = result == OFXEASYOSC_SEQUENCE_DUPLICATE || latePolicy == OFXEASYOSC_LATE_DISCARD;
+    addressKey.assign(msg.getAddressData(), msg.getAddressLength());
+    auto it = addressMap.find(addressKey);
+    if (it != addressMap.end()){
+        auto & stats = it->second.sequenceStats;
+        if (result == OFXEASYOSC_SEQUENCE_DUPLICATE){
+            stats.numDuplicates.fetch_add(1, std::memory_order_relaxed);
+        } else if (result == OFXEASYOSC_SEQUENCE_LATE){
+            stats.numReordered.fetch_add(1, std::memory_order_relaxed);
+            if (bDiscard){
+                stats.numDiscarded.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+    return !bDiscard;
+}
+
+inline ofxEasyOscSequenceStats ofxEasyOscReceiver::getSequenceStats(const string& address) const {
+    auto it = addressMap.find(address);
+    return it != addressMap.end() ? it->second.sequenceStats.load() : ofxEasyOscSequenceStats();
+}
+
+inline void ofxEasyOscReceiver::reject(AddressEntry& entry, const ofxEasyOscMessageView& msg){
+    ++entry.numRejected;
+    ++entry.numUnreported;
+    ++numRejected;
+    auto now = chrono::steady_clock::now();
+    if (now - entry.lastReport >= chrono::seconds(1)){
+        ofLogWarning("ofxEasyOscReceiver") << "rejected " << entry.numUnreported << " message(s) with address " << msg.getAddress()
+            << ": expected type tags '" << entry.typeTags << "', got '" << string(msg.getTypeTags(), msg.getTypeTagsLength()) << "'";
+        entry.numUnreported = 0;
+        entry.lastReport = now;
     }
 }
 
@@ -425,48 +2318,182 @@ inline const unordered_multiset<string>& ofxEasyOscReceiver::getIncomingMessages
 
 // register address only (useful in conjunction with methods like gotMessage())
 inline ofxEasyOscReceiver& ofxEasyOscReceiver::add(const string& address) {
-    addressMap[address];
+    getListeners(address);
     return *this;
 }
+
+// registers the address if necessary
+inline list<unique_ptr<ofxOscListener>>& ofxEasyOscReceiver::getListeners(const string& address){
+    auto & entry = addressMap[address];
+    if (!entry.bRegistered){
+        bAddressFilterDirty = true;
+        setSubscriptionsDirty();
+    }
+    entry.bRegistered = true;
+    return entry.listeners;
+}
 // register variable
 template<typename T>
 inline ofxEasyOscReceiver& ofxEasyOscReceiver::add(const string& address, T* var){
-    addressMap[address].push_back(unique_ptr<ofxOscListener>(new ofxOscVariable<T>(var)));
+    getListeners(address).push_back(unique_ptr<ofxOscListener>(new ofxOscVariable<T>(var)));
     return *this;
 }
 // register free function taking no arguments
 template<typename TReturn>
 inline ofxEasyOscReceiver& ofxEasyOscReceiver::add(const string& address, TReturn(*func)()){
-    addressMap[address].push_back(unique_ptr<ofxOscListener>(new ofxOscFunction<TReturn, void>(func)));
+    getListeners(address).push_back(unique_ptr<ofxOscListener>(new ofxOscFunction<TReturn, void>(func)));
     return *this;
 }
 // register free function taking a single argument
 template<typename TArg, typename TReturn>
 inline ofxEasyOscReceiver& ofxEasyOscReceiver::add(const string& address, TReturn(*func)(TArg)){
-    addressMap[address].push_back(unique_ptr<ofxOscListener>(new ofxOscFunction<TReturn, TArg>(func)));
+    getListeners(address).push_back(unique_ptr<ofxOscListener>(new ofxOscFunction<TReturn, TArg>(func)));
     return *this;
 }
 // register lambda function taking no arguments
 inline ofxEasyOscReceiver& ofxEasyOscReceiver::add(const string& address, const function<void()> & lambda){
-    addressMap[address].push_back(unique_ptr<ofxOscListener>(new ofxOscLambdaFunction<void>(lambda)));
+    getListeners(address).push_back(unique_ptr<ofxOscListener>(new ofxOscLambdaFunction<void>(lambda)));
     return *this;
 }
 // register lambda function taking a single argument
 template<typename TArg>
 inline ofxEasyOscReceiver& ofxEasyOscReceiver::add(const string& address, const function<void(TArg)> & lambda){
-    addressMap[address].push_back(unique_ptr<ofxOscListener>(new ofxOscLambdaFunction<TArg>(lambda)));
+    getListeners(address).push_back(unique_ptr<ofxOscListener>(new ofxOscLambdaFunction<TArg>(lambda)));
     return *this;
 }
 // register member function taking no arguments
 template<typename TReturn, typename TObject>
 inline ofxEasyOscReceiver& ofxEasyOscReceiver::add(const string& address, TObject* obj, TReturn(TObject::*func)()){
-    addressMap[address].push_back(unique_ptr<ofxOscListener>(new ofxOscMemberFunction<TObject, TReturn, void>(obj, func)));
+    getListeners(address).push_back(unique_ptr<ofxOscListener>(new ofxOscMemberFunction<TObject, TReturn, void>(obj, func)));
     return *this;
 }
 // register member function taking a single argument
 template<typename TArg, typename TReturn, typename TObject>
 inline ofxEasyOscReceiver& ofxEasyOscReceiver::add(const string& address, TObject* obj, TReturn(TObject::*func)(TArg)){
-    addressMap[address].push_back(unique_ptr<ofxOscListener>(new ofxOscMemberFunction<TObject, TReturn, TArg>(obj, func)));
+    getListeners(address).push_back(unique_ptr<ofxOscListener>(new ofxOscMemberFunction<TObject, TReturn, TArg>(obj, func)));
+    return *this;
+}
+
+/* register typed OSC addresses */
+
+template<typename TArg, char... Tags>
+inline ofxEasyOscReceiver::AddressEntry& ofxEasyOscReceiver::declare(const ofxEasyOscAddress<Tags...>& address){
+    static_assert(ofxEasyOscMatchesSignature<typename std::decay<TArg>::type, Tags...>::value,
+                  "ofxEasyOsc: the variable/argument type doesn't match the type signature of the address");
+    setSignature(address.getPath(), address.getTypeTags());
+    auto & entry = addressMap[address.getPath()];
+    if (!entry.bRegistered){
+        bAddressFilterDirty = true;
+        setSubscriptionsDirty();
+    }
+    entry.bRegistered = true;
+    return entry;
+}
+
+template<char... Tags>
+inline ofxEasyOscReceiver& ofxEasyOscReceiver::add(const ofxEasyOscAddress<Tags...>& address){
+    declare<void>(address);
+    return *this;
+}
+
+template<typename T, char... Tags>
+inline ofxEasyOscReceiver& ofxEasyOscReceiver::add(const ofxEasyOscAddress<Tags...>& address, T* var){
+    declare<T>(address).listeners.push_back(unique_ptr<ofxOscListener>(new ofxOscVariable<T>(var)));
+    return *this;
+}
+
+template<typename TReturn, char... Tags>
+inline ofxEasyOscReceiver& ofxEasyOscReceiver::add(const ofxEasyOscAddress<Tags...>& address, TReturn(*func)()){
+    declare<void>(address).listeners.push_back(unique_ptr<ofxOscListener>(new ofxOscFunction<TReturn, void>(func)));
+    return *this;
+}
+
+template<typename TArg, typename TReturn, char... Tags>
+inline ofxEasyOscReceiver& ofxEasyOscReceiver::add(const ofxEasyOscAddress<Tags...>& address, TReturn(*func)(TArg)){
+    declare<TArg>(address).listeners.push_back(unique_ptr<ofxOscListener>(new ofxOscFunction<TReturn, TArg>(func)));
+    return *this;
+}
+
+template<char... Tags>
+inline ofxEasyOscReceiver& ofxEasyOscReceiver::add(const ofxEasyOscAddress<Tags...>& address, const function<void()> & lambda){
+    declare<void>(address).listeners.push_back(unique_ptr<ofxOscListener>(new ofxOscLambdaFunction<void>(lambda)));
+    return *this;
+}
+
+template<typename TArg, char... Tags>
+inline ofxEasyOscReceiver& ofxEasyOscReceiver::add(const ofxEasyOscAddress<Tags...>& address, const function<void(TArg)> & lambda){
+    declare<TArg>(address).listeners.push_back(unique_ptr<ofxOscListener>(new ofxOscLambdaFunction<TArg>(lambda)));
+    return *this;
+}
+
+template<typename TReturn, typename TObject, char... Tags>
+inline ofxEasyOscReceiver& ofxEasyOscReceiver::add(const ofxEasyOscAddress<Tags...>& address, TObject* obj, TReturn(TObject::*func)()){
+    declare<void>(address).listeners.push_back(unique_ptr<ofxOscListener>(new ofxOscMemberFunction<TObject, TReturn, void>(obj, func)));
+    return *this;
+}
+
+template<typename TArg, typename TReturn, typename TObject, char... Tags>
+inline ofxEasyOscReceiver& ofxEasyOscReceiver::add(const ofxEasyOscAddress<Tags...>& address, TObject* obj, TReturn(TObject::*func)(TArg)){
+    declare<TArg>(address).listeners.push_back(unique_ptr<ofxOscListener>(new ofxOscMemberFunction<TObject, TReturn, TArg>(obj, func)));
+    return *this;
+}
+
+// declare the type signature of an address
+inline ofxEasyOscReceiver& ofxEasyOscReceiver::setSignature(const string& address, const string& typeTags){
+    const string tags = (!typeTags.empty() && typeTags[0] == ',') ? typeTags.substr(1) : typeTags;
+    bAddressFilterDirty |= addressMap.find(address) == addressMap.end();
+    auto & entry = addressMap[address];
+    if (entry.bTyped && entry.typeTags != tags){
+        ofLogWarning("ofxEasyOscReceiver") << "type signature of " << address << " changed from '" << entry.typeTags << "' to '" << tags << "'";
+    }
+    entry.bTyped = !tags.empty();
+    entry.typeTags = tags;
+    entry.typeTagHash = ofxEasyOscHashTypeTags(tags.data(), tags.size());
+    return *this;
+}
+
+inline ofxEasyOscReceiver& ofxEasyOscReceiver::removeSignature(const string& address){
+    auto found = addressMap.find(address);
+    if (found != addressMap.end()){
+        found->second.bTyped = false;
+        found->second.typeTags.clear();
+    }
+    return *this;
+}
+
+inline uint64_t ofxEasyOscReceiver::getNumRejectedMessages(const string& address) const {
+    auto found = addressMap.find(address);
+    return (found != addressMap.end()) ? found->second.numRejected : 0;
+}
+
+/* priority classes */
+
+inline ofxEasyOscReceiver& ofxEasyOscReceiver::setPriority(const string& address, ofxEasyOscPriority priority){
+    bAddressFilterDirty |= addressMap.find(address) == addressMap.end();
+    addressMap[address].priority = priority;
+    bPriorities = true;
+    return *this;
+}
+
+inline ofxEasyOscPriority ofxEasyOscReceiver::getPriority(const string& address) const {
+    auto found = addressMap.find(address);
+    return (found != addressMap.end()) ? found->second.priority : defaultPriority;
+}
+
+inline ofxEasyOscReceiver& ofxEasyOscReceiver::setDefaultPriority(ofxEasyOscPriority priority){
+    defaultPriority = priority;
+    bPriorities = true;
+    return *this;
+}
+
+inline ofxEasyOscReceiver& ofxEasyOscReceiver::setBacklogThreshold(size_t numMessages){
+    backlogThreshold = numMessages;
+    bPriorities = true;
+    return *this;
+}
+
+inline ofxEasyOscReceiver& ofxEasyOscReceiver::setOverloadPolicy(ofxEasyOscPriority priority, ofxEasyOscOverloadPolicy policy){
+    overloadPolicy[priority] = policy;
     return *this;
 }
 
@@ -521,13 +2548,20 @@ inline ofxEasyOscReceiver& ofxEasyOscReceiver::removeLambdas(const string& addre
 
 // unregister *single* address with *all* its listeners from the map
 inline ofxEasyOscReceiver& ofxEasyOscReceiver::remove(const string& address){
-    addressMap.erase(address);
+    if (addressMap.erase(address)){
+        deltaDecoder.remove(address);
+        bAddressFilterDirty = true;
+        setSubscriptionsDirty();
+    }
     return *this;
 }
 
 // unregister *all* addresses with *all* its listeners from the map
 inline ofxEasyOscReceiver& ofxEasyOscReceiver::removeAll(){
     addressMap.clear();
+    deltaDecoder.clear();
+    bAddressFilterDirty = true;
+    setSubscriptionsDirty();
 	return *this;
 }
 
@@ -549,18 +2583,93 @@ inline ofxEasyOscReceiver& ofxEasyOscReceiver::setDefaultListener(TObject* obj,
 	return *this;
 }
 
+inline ofxEasyOscReceiver& ofxEasyOscReceiver::setDefaultListener(void (*func)(const ofxEasyOscMessageView&)){
+    defaultListener = unique_ptr<ofxOscListener>(new ofxOscFunction<void, const ofxEasyOscMessageView&>(func));
+    return *this;
+}
+
+inline ofxEasyOscReceiver& ofxEasyOscReceiver::setDefaultListener(const function<void(const ofxEasyOscMessageView&)>& lambda){
+    defaultListener = unique_ptr<ofxOscListener>(new ofxOscLambdaFunction<const ofxEasyOscMessageView&>(lambda));
+    return *this;
+}
+
+template <typename TObject>
+inline ofxEasyOscReceiver& ofxEasyOscReceiver::setDefaultListener(TObject* obj, void (TObject::*func)(const ofxEasyOscMessageView&)){
+    defaultListener = unique_ptr<ofxOscListener>(new ofxOscMemberFunction<TObject, void, const ofxEasyOscMessageView&>(obj, func));
+    return *this;
+}
+
 /* remove default listener */
 inline ofxEasyOscReceiver& ofxEasyOscReceiver::removeDefaultListener(){
 	defaultListener = nullptr;
 	return *this;
 }
 
+/* namespaces */
+
+inline ofxEasyOscReceiver& ofxEasyOscReceiver::mount(const string& prefix, ofxEasyOscReceiver* child){
+    string path = prefix;
+    while (!path.empty() && path.back() == '/'){
+        path.pop_back();
+    }
+    if (!child || child == this || path.empty() || path[0] != '/'){
+        ofLogError("ofxEasyOscReceiver") << "can't mount a receiver at '" << prefix << "'";
+        return *this;
+    }
+    if (child->parent){
+        ofLogError("ofxEasyOscReceiver") << "the receiver for '" << prefix << "' is already mounted";
+        return *this;
+    }
+    // mounting an ancestor would create a cycle
+    for (ofxEasyOscReceiver* receiver = parent; receiver; receiver = receiver->parent){
+        if (receiver == child){
+            ofLogError("ofxEasyOscReceiver") << "can't mount a parent of the receiver at '" << prefix << "'";
+            return *this;
+        }
+    }
+    unmount(path);
+    Mount mount;
+    mount.prefix = path;
+    mount.receiver = child;
+    mounts.push_back(mount);
+    indexMounts();
+    child->parent = this;
+    setSubscriptionsDirty();
+    return *this;
+}
+
+inline ofxEasyOscReceiver& ofxEasyOscReceiver::unmount(const string& prefix){
+    string path = prefix;
+    while (!path.empty() && path.back() == '/'){
+        path.pop_back();
+    }
+    for (auto it = mounts.begin(); it != mounts.end(); ++it){
+        if (it->prefix == path){
+            it->receiver->parent = nullptr;
+            mounts.erase(it);
+            indexMounts();
+            setSubscriptionsDirty();
+            break;
+        }
+    }
+    return *this;
+}
+
+inline ofxEasyOscReceiver& ofxEasyOscReceiver::setEnabled(bool bEnable){
+    if (bEnable != bEnabled){
+        bEnabled = bEnable;
+        // senders can stop sending the namespace
+        setSubscriptionsDirty();
+    }
+    return *this;
+}
+
 
 
 inline void ofxEasyOscReceiver::searchAndRemove(const string& address, ofxOscListener* testobj){
     auto found = addressMap.find(address);
     if (found != addressMap.end()){
-        auto & listeners = found->second;
+        auto & listeners = found->second.listeners;
         auto it = listeners.begin();
         while (it != listeners.end()){
             // compare each listener with the test object
@@ -576,7 +2685,7 @@ inline void ofxEasyOscReceiver::searchAndRemove(const string& address, ofxOscLis
 inline void ofxEasyOscReceiver::searchAndRemoveLambdas(const string& address){
     auto found = addressMap.find(address);
     if (found != addressMap.end()){
-        auto & listeners = found->second;
+        auto & listeners = found->second.listeners;
         auto it = listeners.begin();
         while (it != listeners.end()){
             // check if listener is lambda
@@ -0,0 +1,44 @@
+#pragma once
+
+/// Selects where ofxEasyOsc gets its openFrameworks types from.
+///
+/// By default the addon is used inside an openFrameworks project and simply includes ofMain.h and ofxOsc.h.
+/// If OFXEASYOSC_HEADLESS is defined (the CMake target ofxEasyOsc::core does this for you), ofxEasyOscHeadless.h
+/// provides minimal stand-ins for the few openFrameworks types the addon actually uses (ofVec*, ofMatrix*, ofBuffer,
+/// ofxOscMessage, logging), so relay or bridge services only depend on the C++ standard library.
+
+#ifdef OFXEASYOSC_HEADLESS
+#include "ofxEasyOscHeadless.h"
+#else
+#include "ofMain.h"
+#include "ofxOsc.h"
+#endif
+
+// optional C++17 features
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#include <string_view>
+#include <charconv>
+#define OFXEASYOSC_HAS_STRING_VIEW 1
+// polymorphic allocators (not shipped with every C++17 standard library)
+#if defined(__has_include)
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#define OFXEASYOSC_HAS_PMR 1
+#endif
+#elif defined(_MSC_VER)
+#include <memory_resource>
+#define OFXEASYOSC_HAS_PMR 1
+#endif
+#endif
+
+// glm vectors/matrices (openFrameworks 0.10+ or a glm installation in headless builds)
+#if defined(OFXEASYOSC_HEADLESS)
+#if defined(__has_include)
+#if __has_include(<glm/glm.hpp>)
+#include <glm/glm.hpp>
+#define OFXEASYOSC_HAS_GLM 1
+#endif
+#endif
+#elif defined(OF_VERSION_MINOR) && (OF_VERSION_MAJOR > 0 || OF_VERSION_MINOR >= 10)
+#define OFXEASYOSC_HAS_GLM 1
+#endif
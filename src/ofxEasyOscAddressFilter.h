@@ -0,0 +1,81 @@
+#pragma once
+
+#include "ofxEasyOscAdapter.h"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/// Pre-filter for the addresses of ofxEasyOscReceiver (see ofxEasyOscReceiver::setAddressFilter()).
+///
+/// A blocked Bloom filter over the registered addresses: every address sets 4 bits in a single 64 bit word, so a lookup
+/// is one hash over the raw address bytes and one memory access. Messages for other addresses are dropped before their
+/// type tags and arguments are parsed. There are no false negatives, false positives (about 0.5% with 16 bits per address)
+/// simply take the usual path and are sorted out by the map lookup.
+
+class ofxEasyOscAddressFilter {
+public:
+    ofxEasyOscAddressFilter() : bits(1, 0), mask(0) {}
+
+    // start over with room for 'numAddresses'
+    void reset(size_t numAddresses);
+    void insert(const char* address, size_t length);
+    void insert(const string& address) { insert(address.data(), address.size()); }
+
+    bool mayContain(const char* address, size_t length) const { return test(hash(address, length)); }
+
+    static uint64_t hash(const char* address, size_t length);
+
+protected:
+    // the low bits select the word, the high bits the 4 bits in it
+    static uint64_t probe(uint64_t h){
+        return (uint64_t(1) << ((h >> 40) & 63)) | (uint64_t(1) << ((h >> 46) & 63))
+             | (uint64_t(1) << ((h >> 52) & 63)) | (uint64_t(1) << ((h >> 58) & 63));
+    }
+    bool test(uint64_t h) const {
+        const uint64_t p = probe(h);
+        return (bits[h & mask] & p) == p;
+    }
+
+    vector<uint64_t> bits;
+    uint64_t mask;
+};
+
+/* definitions */
+
+inline void ofxEasyOscAddressFilter::reset(size_t numAddresses){
+    // 16 bits per address, power of two number of words
+    size_t numWords = 8;
+    while (numWords * 4 < numAddresses){
+        numWords *= 2;
+    }
+    bits.assign(numWords, 0);
+    mask = numWords - 1;
+}
+
+inline void ofxEasyOscAddressFilter::insert(const char* address, size_t length){
+    const uint64_t h = hash(address, length);
+    bits[h & mask] |= probe(h);
+}
+
+inline uint64_t ofxEasyOscAddressFilter::hash(const char* address, size_t length){
+    // 8 bytes at a time, then the fmix64 finalizer of MurmurHash3
+    uint64_t h = length * 0x9E3779B97F4A7C15ULL;
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8){
+        uint64_t word;
+        std::memcpy(&word, address + i, 8);
+        h = (h ^ word) * 0xFF51AFD7ED558CCDULL;
+        h ^= h >> 29;
+    }
+    if (i < length){
+        uint64_t word = 0;
+        std::memcpy(&word, address + i, length - i);
+        h = (h ^ word) * 0xFF51AFD7ED558CCDULL;
+    }
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+    return h;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "ofxEasyOscAdapter.h"
+
+#ifdef OFXEASYOSC_HAS_PMR
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+//*-------------------------------------------------------------------------------------------------------*//
+/// ofxEasyOscArena
+
+/// Bump allocator for the temporary arguments of listeners (see ofxEasyOscReceiver::update()).
+///
+/// Allocation only advances a pointer, deallocation does nothing and reset() frees everything at once.
+/// The blocks are kept across reset(), so once the arena has seen its largest update it doesn't allocate anymore.
+/// Listeners taking std::pmr::string, std::pmr::vector<T> (or a const reference to them) get their argument
+/// constructed from the receiver's arena instead of the heap.
+
+class ofxEasyOscArena : public std::pmr::memory_resource {
+public:
+    ofxEasyOscArena(size_t blockSize_ = 65536) : blockSize(blockSize_), current(0), offset(0), used(0), peak(0) {}
+
+    ofxEasyOscArena(const ofxEasyOscArena&) = delete;
+    ofxEasyOscArena& operator=(const ofxEasyOscArena&) = delete;
+
+    // free all allocations at once (the memory is kept for reuse)
+    void reset();
+
+    // number of bytes handed out since the last reset()
+    size_t getUsed() const { return used; }
+    // maximum of getUsed() so far
+    size_t getPeak() const { return peak; }
+    // total size of all blocks
+    size_t getCapacity() const;
+    size_t getNumBlocks() const { return blocks.size(); }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* /*p*/, size_t /*bytes*/, size_t /*alignment*/) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+    std::vector<Block> blocks;
+    size_t blockSize;
+    size_t current; // index of the block we're allocating from
+    size_t offset; // position in the current block
+    size_t used;
+    size_t peak;
+};
+
+/* definitions */
+
+inline void ofxEasyOscArena::reset(){
+    current = 0;
+    offset = 0;
+    used = 0;
+}
+
+inline size_t ofxEasyOscArena::getCapacity() const {
+    size_t capacity = 0;
+    for (auto& block : blocks){
+        capacity += block.size;
+    }
+    return capacity;
+}
+
+inline void* ofxEasyOscArena::do_allocate(size_t bytes, size_t alignment){
+    while (current < blocks.size()){
+        Block& block = blocks[current];
+        const uintptr_t base = reinterpret_cast<uintptr_t>(block.data.get());
+        const uintptr_t aligned = (base + offset + alignment - 1) & ~uintptr_t(alignment - 1);
+        if (aligned + bytes <= base + block.size){
+            offset = aligned + bytes - base;
+            used += bytes;
+            if (used > peak){
+                peak = used;
+            }
+            return reinterpret_cast<void*>(aligned);
+        }
+        // try the next block (the rest of this one is wasted until reset())
+        ++current;
+        offset = 0;
+    }
+    // add a new block which is large enough
+    Block block;
+    block.size = std::max(blockSize, bytes + alignment);
+    block.data.reset(new char[block.size]);
+    blocks.push_back(std::move(block));
+    return do_allocate(bytes, alignment);
+}
+
+#endif
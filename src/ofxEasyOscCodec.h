@@ -0,0 +1,801 @@
+#pragma once
+
+#include "ofxEasyOscAdapter.h"
+#include "ofxEasyOscSocket.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/// Self-contained OSC 1.0/1.1 codec used by ofxEasyOscSender and ofxEasyOscReceiver.
+///
+/// ofxEasyOscWriter encodes a message straight into a reusable byte buffer and ofxEasyOscMessageView decodes a message
+/// in place, without copying the packet or creating per-argument objects. Both are bounds-checked: the writer never
+/// produces a datagram larger than its size limit and the view validates the whole message before any argument can be read.
+///
+/// Supported type tags: i f s S b h d t c r m T F N I and arrays ([ ]). Arrays are flattened, i.e. the brackets
+/// don't count as arguments when reading a message.
+
+//*-------------------------------------------------------------------------------------------------------*//
+/// big-endian helpers
+
+inline void ofxEasyOscWrite32(char* dest, uint32_t value){
+    dest[0] = static_cast<char>(value >> 24);
+    dest[1] = static_cast<char>(value >> 16);
+    dest[2] = static_cast<char>(value >> 8);
+    dest[3] = static_cast<char>(value);
+}
+
+inline void ofxEasyOscWrite64(char* dest, uint64_t value){
+    ofxEasyOscWrite32(dest, static_cast<uint32_t>(value >> 32));
+    ofxEasyOscWrite32(dest + 4, static_cast<uint32_t>(value));
+}
+
+inline uint32_t ofxEasyOscByteSwap32(uint32_t value){
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_bswap32(value);
+#elif defined(_MSC_VER)
+    return _byteswap_ulong(value);
+#else
+    return (value >> 24) | ((value >> 8) & 0xff00) | ((value << 8) & 0xff0000) | (value << 24);
+#endif
+}
+
+inline uint32_t ofxEasyOscRead32(const char* src){
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(src);
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+}
+
+inline uint64_t ofxEasyOscRead64(const char* src){
+    return (uint64_t(ofxEasyOscRead32(src)) << 32) | ofxEasyOscRead32(src + 4);
+}
+
+// size of a string including the terminating zero, padded to 4 bytes
+inline size_t ofxEasyOscPaddedSize(size_t length){
+    return (length + 4) & ~size_t(3);
+}
+
+// FNV-1a hash of a type tag string (without the leading ','), see ofxEasyOscMessageView::getTypeTagHash()
+static const uint32_t ofxEasyOscTypeTagHashSeed = 2166136261u;
+
+inline uint32_t ofxEasyOscHashTypeTag(uint32_t hash, char tag){
+    return (hash ^ static_cast<unsigned char>(tag)) * 16777619u;
+}
+
+// FNV-1a hash of arbitrary bytes (type tags, addresses...)
+inline uint32_t ofxEasyOscHash(const char* data, size_t length){
+    uint32_t hash = ofxEasyOscTypeTagHashSeed;
+    for (size_t i = 0; i < length; ++i){
+        hash = ofxEasyOscHashTypeTag(hash, data[i]);
+    }
+    return hash;
+}
+
+inline uint32_t ofxEasyOscHashTypeTags(const char* tags, size_t length){
+    return ofxEasyOscHash(tags, length);
+}
+
+//*-------------------------------------------------------------------------------------------------------*//
+/// ofxEasyOscTimetag
+
+/// OSC time tag (NTP format: seconds since 1900 in the upper 32 bits, fraction in the lower 32 bits).
+/// Sent and received as the 't' type, so it never loses precision.
+
+struct ofxEasyOscTimetag {
+    // 1 means "immediately"
+    ofxEasyOscTimetag(uint64_t value_ = 1) : value(value_) {}
+
+    // current system time
+    static ofxEasyOscTimetag now();
+    // convert from/to seconds since the Unix epoch
+    static ofxEasyOscTimetag fromUnixTime(double seconds);
+    double toUnixTime() const;
+
+    bool operator==(const ofxEasyOscTimetag& other) const { return value == other.value; }
+    bool operator!=(const ofxEasyOscTimetag& other) const { return value != other.value; }
+    bool operator<(const ofxEasyOscTimetag& other) const { return value < other.value; }
+
+    uint64_t value;
+};
+
+//*-------------------------------------------------------------------------------------------------------*//
+/// ofxEasyOscWriter
+
+/// Encodes a single OSC message. Call begin(), add the arguments and finish with end().
+/// The internal buffer only grows, so encoding doesn't allocate once it has reached the typical message size.
+/// If the message would exceed getMaxSize() (by default the maximum UDP payload), end() returns false.
+
+class ofxEasyOscWriter {
+public:
+    ofxEasyOscWriter(size_t maxSize_ = 65507) : maxSize(maxSize_), argStart(0), tagGap(0), depth(0), bOverflow(false) {}
+
+    void setMaxSize(size_t size) { maxSize = size; }
+    size_t getMaxSize() const { return maxSize; }
+
+    // start a new message. 'numArgs' is a hint to reserve space for the type tags and the arguments.
+    void begin(const char* address, size_t length, size_t numArgs = 8);
+    void begin(const string& address, size_t numArgs = 8) { begin(address.data(), address.size(), numArgs); }
+    // finish the message. returns false if the message was too large or the arrays are unbalanced.
+    bool end();
+
+    void addInt32(int32_t value);
+    void addInt64(int64_t value);
+    void addFloat(float value);
+    // add 'n' floats in one go (memcpy + byte swap, which the compiler vectorizes)
+    void addFloats(const float* values, size_t n);
+    void addDouble(double value);
+    void addString(const char* str, size_t length);
+    void addString(const string& str) { addString(str.data(), str.size()); }
+    void addString(const char* str) { addString(str, std::strlen(str)); }
+    void addSymbol(const char* str, size_t length);
+    void addBlob(const void* data, size_t size);
+    // add a blob and return a pointer to its (zeroed) content, so it can be filled in place (nullptr on overflow)
+    char* addBlob(size_t size);
+    void addTimetag(uint64_t value);
+    void addChar(char value);
+    void addRgbaColor(uint32_t value);
+    void addMidiMessage(uint32_t value);
+    void addBool(bool value) { addTag(value ? 'T' : 'F'); }
+    void addNil() { addTag('N'); }
+    void addImpulse() { addTag('I'); }
+    void beginArray() { addTag('['); ++depth; }
+    void endArray() { addTag(']'); --depth; }
+
+    // the encoded message (only valid after end() returned true)
+    const char* data() const { return packet.data(); }
+    size_t size() const { return packet.size(); }
+
+protected:
+    void addTag(char tag) { tags.push_back(tag); }
+    // reserve 'n' bytes for argument data and return a pointer to them (nullptr on overflow)
+    char* grow(size_t n);
+    void addPaddedString(char tag, const char* str, size_t length);
+
+    size_t maxSize;
+    size_t argStart; // start of argument data
+    size_t tagGap; // space reserved for the type tag string
+    int depth; // array nesting
+    bool bOverflow;
+    vector<char> tags;
+    vector<char> packet;
+};
+
+//*-------------------------------------------------------------------------------------------------------*//
+/// ofxEasyOscMessageView
+
+/// Read-only view of an encoded OSC message. The view points into the packet, so it is only valid as long as
+/// the packet buffer (e.g. during ofxEasyOscReceiver::update()).
+/// The accessors have the same names as ofxOscMessage. Numeric accessors convert between all numeric types
+/// (i h f d c T F), the other accessors return an empty value for mismatching types.
+/// Sequential access (index 0, 1, 2...) is O(1) per argument.
+
+class ofxEasyOscMessageView {
+public:
+    ofxEasyOscMessageView() { reset(); }
+
+    // parse and validate a message. returns false if the message is malformed.
+    bool parse(const char* data, size_t size);
+
+    const char* getAddressData() const { return address; }
+    size_t getAddressLength() const { return addressLength; }
+    string getAddress() const { return string(address, addressLength); }
+    // type tag string without the leading ',' (including array brackets)
+    const char* getTypeTags() const { return typeTags; }
+    size_t getTypeTagsLength() const { return typeTagsLength; }
+    // hash of the type tag string (computed while parsing, see ofxEasyOscHashTypeTags())
+    uint32_t getTypeTagHash() const { return typeTagHash; }
+    // the raw message
+    const char* getData() const { return data; }
+    size_t getSize() const { return size; }
+
+    void setRemoteEndpoint(const ofxEasyOscEndpoint& endpoint) { remote = endpoint; }
+    const ofxEasyOscEndpoint& getRemoteEndpoint() const { return remote; }
+    string getRemoteHost() const { return remote.getHost(); }
+    string getRemoteIp() const { return remote.getHost(); }
+    int getRemotePort() const { return remote.getPort(); }
+
+    int getNumArgs() const { return numArgs; }
+    ofxOscArgType getArgType(int index) const;
+
+    int32_t getArgAsInt(int index) const { return getArgAsInt32(index); }
+    int32_t getArgAsInt32(int index) const;
+    int64_t getArgAsInt64(int index) const;
+    float getArgAsFloat(int index) const;
+    double getArgAsDouble(int index) const;
+    bool getArgAsBool(int index) const;
+    char getArgAsChar(int index) const { return static_cast<char>(getArgAsInt32(index)); }
+    uint64_t getArgAsTimetag(int index) const;
+    uint32_t getArgAsMidiMessage(int index) const;
+    uint32_t getArgAsRgbaColor(int index) const;
+    bool getArgAsTrigger(int index) const { return getArgType(index) == OFXOSC_TYPE_TRIGGER; }
+    bool getArgAsImpulse(int index) const { return getArgAsTrigger(index); }
+    // string or symbol. returns a pointer into the packet (nullptr for other types).
+    const char* getArgAsCString(int index, size_t* length = nullptr) const;
+    string getArgAsString(int index) const;
+#ifdef OFXEASYOSC_HAS_STRING_VIEW
+    // points into the packet
+    std::string_view getArgAsStringView(int index) const;
+#endif
+    string getArgAsSymbol(int index) const { return getArgAsString(index); }
+    // blob without copying. returns false for other types.
+    bool getArgAsBlob(int index, const char*& blobData, size_t& blobSize) const;
+    ofBuffer getArgAsBlob(int index) const;
+
+protected:
+    void reset();
+    // find the type tag and data of an argument. returns 0 if out of range.
+    char seek(int index, const char*& argData) const;
+
+    const char* data;
+    size_t size;
+    const char* address;
+    size_t addressLength;
+    const char* typeTags;
+    size_t typeTagsLength;
+    uint32_t typeTagHash;
+    const char* argData;
+    int numArgs;
+    ofxEasyOscEndpoint remote;
+    // cursor for sequential access
+    mutable int cursorIndex;
+    mutable size_t cursorTag;
+    mutable const char* cursorData;
+};
+
+//*-------------------------------------------------------------------------------------------------------*//
+/// ofxEasyOscParsePacket
+
+/// Walks a datagram and calls 'callback(const char* data, size_t size)' for every message it contains.
+/// Bundles are unpacked recursively. Returns false if the packet is malformed (messages before the
+/// malformed part have already been passed to the callback).
+
+template <typename TCallback>
+bool ofxEasyOscParsePacket(const char* data, size_t size, TCallback&& callback, int depth = 0);
+
+inline bool ofxEasyOscIsBundle(const char* data, size_t size){
+    return size >= 16 && std::memcmp(data, "#bundle", 8) == 0;
+}
+
+/* definitions */
+
+// seconds between 1900 (NTP) and 1970 (Unix)
+#define OFXEASYOSC_NTP_UNIX_OFFSET 2208988800ULL
+
+inline ofxEasyOscTimetag ofxEasyOscTimetag::now(){
+    using namespace std::chrono;
+    const uint64_t micros = duration_cast<microseconds>(system_clock::now().time_since_epoch()).count();
+    const uint64_t seconds = micros / 1000000 + OFXEASYOSC_NTP_UNIX_OFFSET;
+    const uint64_t fraction = ((micros % 1000000) << 32) / 1000000;
+    return ofxEasyOscTimetag((seconds << 32) | fraction);
+}
+
+inline ofxEasyOscTimetag ofxEasyOscTimetag::fromUnixTime(double seconds){
+    const double ntp = seconds + OFXEASYOSC_NTP_UNIX_OFFSET;
+    const uint64_t whole = static_cast<uint64_t>(ntp);
+    const uint64_t fraction = static_cast<uint64_t>((ntp - whole) * 4294967296.0);
+    return ofxEasyOscTimetag((whole << 32) | fraction);
+}
+
+inline double ofxEasyOscTimetag::toUnixTime() const {
+    return static_cast<double>(value >> 32) - OFXEASYOSC_NTP_UNIX_OFFSET
+            + static_cast<double>(value & 0xffffffff) / 4294967296.0;
+}
+
+inline void ofxEasyOscWriter::begin(const char* addr, size_t length, size_t numArgs){
+    tags.clear();
+    tags.push_back(',');
+    depth = 0;
+    bOverflow = false;
+
+    const size_t addrSize = ofxEasyOscPaddedSize(length);
+    if (addrSize + 4 > maxSize){
+        bOverflow = true;
+        packet.clear();
+        return;
+    }
+    tagGap = ofxEasyOscPaddedSize(numArgs + 1);
+    if (addrSize + tagGap > maxSize){
+        // the hint is too large anyway, let end() decide
+        tagGap = 4;
+    }
+    argStart = addrSize + tagGap;
+    // reserve space for the whole message once (at least 4 bytes per argument)
+    tags.reserve(numArgs + 1);
+    packet.reserve(std::min(argStart + numArgs * 4, maxSize));
+    packet.resize(argStart);
+    std::memcpy(packet.data(), addr, length);
+    std::memset(packet.data() + length, 0, addrSize - length);
+}
+
+inline bool ofxEasyOscWriter::end(){
+    if (bOverflow || depth != 0){
+        packet.clear();
+        return false;
+    }
+    const size_t tagSize = ofxEasyOscPaddedSize(tags.size());
+    const size_t addrSize = argStart - tagGap;
+    const size_t argSize = packet.size() - argStart;
+    if (addrSize + tagSize + argSize > maxSize){
+        packet.clear();
+        return false;
+    }
+    if (tagSize != tagGap){
+        // the type tag hint was wrong -> move the arguments
+        if (tagSize > tagGap){
+            packet.resize(packet.size() + tagSize - tagGap);
+        }
+        std::memmove(packet.data() + addrSize + tagSize, packet.data() + argStart, argSize);
+        packet.resize(addrSize + tagSize + argSize);
+    }
+    char* dest = packet.data() + addrSize;
+    std::memcpy(dest, tags.data(), tags.size());
+    std::memset(dest + tags.size(), 0, tagSize - tags.size());
+    return true;
+}
+
+inline char* ofxEasyOscWriter::grow(size_t n){
+    if (bOverflow || packet.size() + n > maxSize){
+        bOverflow = true;
+        return nullptr;
+    }
+    const size_t offset = packet.size();
+    packet.resize(offset + n);
+    return packet.data() + offset;
+}
+
+inline void ofxEasyOscWriter::addInt32(int32_t value){
+    addTag('i');
+    if (char* dest = grow(4)){
+        ofxEasyOscWrite32(dest, static_cast<uint32_t>(value));
+    }
+}
+
+inline void ofxEasyOscWriter::addInt64(int64_t value){
+    addTag('h');
+    if (char* dest = grow(8)){
+        ofxEasyOscWrite64(dest, static_cast<uint64_t>(value));
+    }
+}
+
+inline void ofxEasyOscWriter::addFloat(float value){
+    addTag('f');
+    if (char* dest = grow(4)){
+        uint32_t bits;
+        std::memcpy(&bits, &value, 4);
+        ofxEasyOscWrite32(dest, bits);
+    }
+}
+
+inline void ofxEasyOscWriter::addFloats(const float* values, size_t n){
+    tags.insert(tags.end(), n, 'f');
+    if (char* dest = grow(n * 4)){
+        std::memcpy(dest, values, n * 4);
+#if !(defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+        // convert to big endian
+        for (size_t i = 0; i < n; ++i){
+            uint32_t word;
+            std::memcpy(&word, dest + i * 4, 4);
+            word = ofxEasyOscByteSwap32(word);
+            std::memcpy(dest + i * 4, &word, 4);
+        }
+#endif
+    }
+}
+
+inline void ofxEasyOscWriter::addDouble(double value){
+    addTag('d');
+    if (char* dest = grow(8)){
+        uint64_t bits;
+        std::memcpy(&bits, &value, 8);
+        ofxEasyOscWrite64(dest, bits);
+    }
+}
+
+inline void ofxEasyOscWriter::addPaddedString(char tag, const char* str, size_t length){
+    addTag(tag);
+    const size_t padded = ofxEasyOscPaddedSize(length);
+    if (char* dest = grow(padded)){
+        std::memcpy(dest, str, length);
+        std::memset(dest + length, 0, padded - length);
+    }
+}
+
+inline void ofxEasyOscWriter::addString(const char* str, size_t length){
+    addPaddedString('s', str, length);
+}
+
+inline void ofxEasyOscWriter::addSymbol(const char* str, size_t length){
+    addPaddedString('S', str, length);
+}
+
+inline void ofxEasyOscWriter::addBlob(const void* blobData, size_t blobSize){
+    if (char* dest = addBlob(blobSize)){
+        if (blobSize){
+            std::memcpy(dest, blobData, blobSize);
+        }
+    }
+}
+
+inline char* ofxEasyOscWriter::addBlob(size_t blobSize){
+    addTag('b');
+    const size_t padded = (blobSize + 3) & ~size_t(3);
+    if (char* dest = grow(4 + padded)){
+        ofxEasyOscWrite32(dest, static_cast<uint32_t>(blobSize));
+        std::memset(dest + 4, 0, padded);
+        return dest + 4;
+    }
+    return nullptr;
+}
+
+inline void ofxEasyOscWriter::addTimetag(uint64_t value){
+    addTag('t');
+    if (char* dest = grow(8)){
+        ofxEasyOscWrite64(dest, value);
+    }
+}
+
+inline void ofxEasyOscWriter::addChar(char value){
+    addTag('c');
+    if (char* dest = grow(4)){
+        ofxEasyOscWrite32(dest, static_cast<unsigned char>(value));
+    }
+}
+
+inline void ofxEasyOscWriter::addRgbaColor(uint32_t value){
+    addTag('r');
+    if (char* dest = grow(4)){
+        ofxEasyOscWrite32(dest, value);
+    }
+}
+
+inline void ofxEasyOscWriter::addMidiMessage(uint32_t value){
+    addTag('m');
+    if (char* dest = grow(4)){
+        ofxEasyOscWrite32(dest, value);
+    }
+}
+
+//*-------------------------------------------------------------------------------------------------------*//
+
+inline void ofxEasyOscMessageView::reset(){
+    data = nullptr;
+    size = 0;
+    address = "";
+    addressLength = 0;
+    typeTags = "";
+    typeTagsLength = 0;
+    typeTagHash = ofxEasyOscTypeTagHashSeed;
+    argData = nullptr;
+    numArgs = 0;
+    cursorIndex = 0;
+    cursorTag = 0;
+    cursorData = nullptr;
+}
+
+// size of an OSC string starting at 'p' (including padding) or 0 if it isn't terminated before 'end'
+inline size_t ofxEasyOscStringSize(const char* p, const char* end){
+    const void* zero = std::memchr(p, 0, end - p);
+    if (!zero){
+        return 0;
+    }
+    const size_t padded = ofxEasyOscPaddedSize(static_cast<const char*>(zero) - p);
+    return (p + padded <= end) ? padded : 0;
+}
+
+inline bool ofxEasyOscMessageView::parse(const char* msgData, size_t msgSize){
+    reset();
+    const char* end = msgData + msgSize;
+
+    if (msgSize < 4 || (msgSize & 3) || msgData[0] != '/'){
+        return false;
+    }
+    // address
+    size_t n = ofxEasyOscStringSize(msgData, end);
+    if (!n){
+        return false;
+    }
+    const char* p = msgData + n;
+    const char* tags = "";
+    size_t tagsLength = 0;
+    // type tags (optional in OSC 1.0)
+    if (p < end && *p == ','){
+        n = ofxEasyOscStringSize(p, end);
+        if (!n){
+            return false;
+        }
+        tags = p + 1;
+        tagsLength = std::strlen(tags);
+        p += n;
+    }
+    // validate the arguments
+    const char* args = p;
+    int count = 0;
+    int depth = 0;
+    uint32_t hash = ofxEasyOscTypeTagHashSeed;
+    for (size_t i = 0; i < tagsLength; ++i){
+        hash = ofxEasyOscHashTypeTag(hash, tags[i]);
+        switch (tags[i]){
+        case 'i': case 'f': case 'c': case 'r': case 'm':
+            if (end - p < 4) return false;
+            p += 4;
+            break;
+        case 'h': case 'd': case 't':
+            if (end - p < 8) return false;
+            p += 8;
+            break;
+        case 's': case 'S':
+            if (p >= end || !(n = ofxEasyOscStringSize(p, end))) return false;
+            p += n;
+            break;
+        case 'b': {
+            if (end - p < 4) return false;
+            const size_t blobSize = ofxEasyOscRead32(p);
+            const size_t padded = (blobSize + 3) & ~size_t(3);
+            if (blobSize > size_t(end - p) || padded > size_t(end - p - 4)) return false;
+            p += 4 + padded;
+            break;
+        }
+        case 'T': case 'F': case 'N': case 'I':
+            break;
+        case '[':
+            ++depth;
+            continue;
+        case ']':
+            if (--depth < 0) return false;
+            continue;
+        default:
+            // unknown type tag -> we can't know its size
+            return false;
+        }
+        ++count;
+    }
+    if (depth != 0){
+        return false;
+    }
+
+    data = msgData;
+    size = msgSize;
+    address = msgData;
+    addressLength = std::strlen(msgData);
+    typeTags = tags;
+    typeTagsLength = tagsLength;
+    typeTagHash = hash;
+    argData = args;
+    numArgs = count;
+    cursorData = args;
+    return true;
+}
+
+inline char ofxEasyOscMessageView::seek(int index, const char*& result) const {
+    if (index < 0 || index >= numArgs){
+        return 0;
+    }
+    if (index < cursorIndex){
+        // restart from the beginning
+        cursorIndex = 0;
+        cursorTag = 0;
+        cursorData = argData;
+    }
+    // skip array brackets and preceding arguments
+    while (true){
+        const char tag = typeTags[cursorTag];
+        if (tag == '[' || tag == ']'){
+            ++cursorTag;
+            continue;
+        }
+        if (cursorIndex == index){
+            result = cursorData;
+            return tag;
+        }
+        switch (tag){
+        case 'i': case 'f': case 'c': case 'r': case 'm':
+            cursorData += 4;
+            break;
+        case 'h': case 'd': case 't':
+            cursorData += 8;
+            break;
+        case 's': case 'S':
+            cursorData += ofxEasyOscPaddedSize(std::strlen(cursorData));
+            break;
+        case 'b':
+            cursorData += 4 + ((ofxEasyOscRead32(cursorData) + 3) & ~uint32_t(3));
+            break;
+        default:
+            break;
+        }
+        ++cursorTag;
+        ++cursorIndex;
+    }
+}
+
+inline ofxOscArgType ofxEasyOscMessageView::getArgType(int index) const {
+    const char* p;
+    const char tag = seek(index, p);
+    return tag ? static_cast<ofxOscArgType>(tag) : OFXOSC_TYPE_INDEXOUTOFBOUNDS;
+}
+
+inline int32_t ofxEasyOscMessageView::getArgAsInt32(int index) const {
+    const char* p;
+    switch (seek(index, p)){
+    case 'i': case 'c':
+        return static_cast<int32_t>(ofxEasyOscRead32(p));
+    case 'h': case 'f': case 'd':
+        return static_cast<int32_t>(getArgAsInt64(index));
+    case 'T':
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+inline int64_t ofxEasyOscMessageView::getArgAsInt64(int index) const {
+    const char* p;
+    switch (seek(index, p)){
+    case 'h':
+        return static_cast<int64_t>(ofxEasyOscRead64(p));
+    case 'f':
+        return static_cast<int64_t>(getArgAsFloat(index));
+    case 'd':
+        return static_cast<int64_t>(getArgAsDouble(index));
+    case 'i': case 'c': case 'T':
+        return getArgAsInt32(index);
+    default:
+        return 0;
+    }
+}
+
+inline float ofxEasyOscMessageView::getArgAsFloat(int index) const {
+    const char* p;
+    switch (seek(index, p)){
+    case 'f': {
+        const uint32_t bits = ofxEasyOscRead32(p);
+        float value;
+        std::memcpy(&value, &bits, 4);
+        return value;
+    }
+    case 'd':
+        return static_cast<float>(getArgAsDouble(index));
+    case 'i': case 'c': case 'T':
+        return static_cast<float>(getArgAsInt32(index));
+    case 'h':
+        return static_cast<float>(getArgAsInt64(index));
+    default:
+        return 0;
+    }
+}
+
+inline double ofxEasyOscMessageView::getArgAsDouble(int index) const {
+    const char* p;
+    switch (seek(index, p)){
+    case 'd': {
+        const uint64_t bits = ofxEasyOscRead64(p);
+        double value;
+        std::memcpy(&value, &bits, 8);
+        return value;
+    }
+    case 'f':
+        return getArgAsFloat(index);
+    case 'i': case 'c': case 'T':
+        return getArgAsInt32(index);
+    case 'h':
+        return static_cast<double>(getArgAsInt64(index));
+    default:
+        return 0;
+    }
+}
+
+inline bool ofxEasyOscMessageView::getArgAsBool(int index) const {
+    const char* p;
+    switch (seek(index, p)){
+    case 'T':
+        return true;
+    case 'i': case 'c': case 'h':
+        return getArgAsInt64(index) != 0;
+    case 'f': case 'd':
+        return getArgAsDouble(index) != 0;
+    default:
+        return false;
+    }
+}
+
+inline uint64_t ofxEasyOscMessageView::getArgAsTimetag(int index) const {
+    const char* p;
+    return (seek(index, p) == 't') ? ofxEasyOscRead64(p) : 0;
+}
+
+inline uint32_t ofxEasyOscMessageView::getArgAsMidiMessage(int index) const {
+    const char* p;
+    return (seek(index, p) == 'm') ? ofxEasyOscRead32(p) : 0;
+}
+
+inline uint32_t ofxEasyOscMessageView::getArgAsRgbaColor(int index) const {
+    const char* p;
+    return (seek(index, p) == 'r') ? ofxEasyOscRead32(p) : 0;
+}
+
+inline const char* ofxEasyOscMessageView::getArgAsCString(int index, size_t* length) const {
+    const char* p;
+    const char tag = seek(index, p);
+    if (tag == 's' || tag == 'S'){
+        if (length){
+            *length = std::strlen(p);
+        }
+        return p;
+    }
+    if (length){
+        *length = 0;
+    }
+    return nullptr;
+}
+
+inline string ofxEasyOscMessageView::getArgAsString(int index) const {
+    size_t length;
+    const char* str = getArgAsCString(index, &length);
+    return str ? string(str, length) : string();
+}
+
+#ifdef OFXEASYOSC_HAS_STRING_VIEW
+inline std::string_view ofxEasyOscMessageView::getArgAsStringView(int index) const {
+    size_t length;
+    const char* str = getArgAsCString(index, &length);
+    return str ? std::string_view(str, length) : std::string_view();
+}
+#endif
+
+inline bool ofxEasyOscMessageView::getArgAsBlob(int index, const char*& blobData, size_t& blobSize) const {
+    const char* p;
+    if (seek(index, p) == 'b'){
+        blobSize = ofxEasyOscRead32(p);
+        blobData = p + 4;
+        return true;
+    }
+    blobData = nullptr;
+    blobSize = 0;
+    return false;
+}
+
+inline ofBuffer ofxEasyOscMessageView::getArgAsBlob(int index) const {
+    const char* blobData;
+    size_t blobSize;
+    if (getArgAsBlob(index, blobData, blobSize)){
+        return ofBuffer(blobData, blobSize);
+    }
+    return ofBuffer();
+}
+
+//*-------------------------------------------------------------------------------------------------------*//
+
+template <typename TCallback>
+inline bool ofxEasyOscParsePacket(const char* data, size_t size, TCallback&& callback, int depth){
+    if (!ofxEasyOscIsBundle(data, size)){
+        if (size && data[0] == '/'){
+            callback(data, size);
+            return true;
+        }
+        return false;
+    }
+    // don't let malicious packets blow the stack
+    if (depth >= 8){
+        return false;
+    }
+    // skip "#bundle" and time tag
+    const char* p = data + 16;
+    const char* end = data + size;
+    while (p < end){
+        if (end - p < 4){
+            return false;
+        }
+        const size_t elementSize = ofxEasyOscRead32(p);
+        p += 4;
+        if (elementSize > size_t(end - p) || (elementSize & 3)){
+            return false;
+        }
+        if (!ofxEasyOscParsePacket(p, elementSize, callback, depth + 1)){
+            return false;
+        }
+        p += elementSize;
+    }
+    return true;
+}
@@ -0,0 +1,384 @@
+#pragma once
+
+#include "ofxEasyOscAdapter.h"
+#include "ofxEasyOscCodec.h"
+#include "ofxEasyOscRateLimiter.h"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/// Compressed envelopes for large datagrams (see ofxEasyOscSender::setCompression()).
+///
+/// Datagrams above a threshold are compressed with LZ4 (block format, implemented here so there is no extra dependency)
+/// and sent as a "/#z" message with two arguments: the original size (int32) and the compressed datagram (blob).
+/// ofxEasyOscReceiver decompresses them into a reused buffer and dispatches the contained message(s) as usual.
+/// Datagrams which don't get smaller are sent as they are.
+///
+/// Plain OSC peers don't understand "/#z", so by default the sender negotiates: before it compresses anything for a destination
+/// it sends a "/#c" probe (int32 version), and only if the receiver echoes it back, the destination gets compressed datagrams.
+/// Until then (and if no answer arrives after a few probes) everything is sent uncompressed.
+
+// address of the compressed envelope
+#define OFXEASYOSC_COMPRESSED_ADDRESS "/#z"
+// address of the probe/confirmation
+#define OFXEASYOSC_COMPRESSION_PROBE "/#c"
+
+/* LZ4 block format */
+
+// worst case size of the compressed data
+inline size_t ofxEasyOscLz4Bound(size_t size){
+    return size + size / 255 + 16;
+}
+
+// compress 'size' bytes into 'dest' (at least ofxEasyOscLz4Bound(size) bytes). 'table' is a reusable hash table.
+// returns the compressed size.
+inline size_t ofxEasyOscLz4Compress(const char* src, size_t size, char* dest, vector<uint32_t>& table);
+
+// decompress into 'dest' which must be exactly as large as the original data. returns false if the data is malformed.
+inline bool ofxEasyOscLz4Decompress(const char* src, size_t size, char* dest, size_t destSize);
+
+struct ofxEasyOscCompressionStats {
+    ofxEasyOscCompressionStats() : numCompressed(0), numUncompressed(0), numBytesIn(0), numBytesOut(0), numDecompressed(0), numErrors(0) {}
+
+    // sender
+    uint64_t numCompressed; // datagrams
+    uint64_t numUncompressed; // above the threshold, but incompressible or the destination doesn't support compression (yet)
+    uint64_t numBytesIn; // original size of the compressed datagrams
+    uint64_t numBytesOut; // size of the envelopes
+    // receiver
+    uint64_t numDecompressed;
+    uint64_t numErrors; // malformed envelopes
+};
+
+//*-------------------------------------------------------------------------------------------------------*//
+/// ofxEasyOscCompressor
+
+/// Compression and negotiation of ofxEasyOscSender, per destination. sendTo(data, size, destination) sends a probe.
+
+class ofxEasyOscCompressor {
+public:
+    static const int version = 1;
+    static const int maxProbes = 3;
+
+    ofxEasyOscCompressor() : threshold(0), bNegotiate(true) {}
+
+    // compress datagrams of at least 'threshold' bytes (0 = off)
+    void setThreshold(size_t size, bool bNegotiate_);
+    size_t getThreshold() const { return threshold; }
+    bool isActive() const { return threshold > 0; }
+    // still waiting for the answer of a destination
+    bool isNegotiating() const;
+    // the destination has confirmed support (always true without negotiation)
+    bool isSupported(size_t destination) const { return !bNegotiate || channels[destination].state == SUPPORTED; }
+
+    // (re)set the number of destinations
+    void resize(size_t numDestinations) { channels.resize(numDestinations); }
+
+    // returns false if the datagram should be sent uncompressed, otherwise the envelope is in data()/size() (valid until the next call)
+    template <typename TSendTo>
+    bool compress(const char* src, size_t size, size_t destination, TSendTo&& sendTo);
+    const char* data() const { return envelope.data(); }
+    size_t size() const { return envelope.size(); }
+
+    // handle the answer to a probe. returns false if the message isn't one.
+    bool receive(const ofxEasyOscMessageView& msg, size_t destination);
+    // send probes which are due
+    template <typename TSendTo>
+    void update(TSendTo&& sendTo);
+
+    const ofxEasyOscCompressionStats& getStats() const { return stats; }
+
+    // the probe message (also the answer)
+    static bool isProbe(const ofxEasyOscMessageView& msg);
+    static void writeProbe(char* dest);
+    static const size_t probeSize = 12;
+
+    // decompress an envelope into 'buffer'. returns false if 'msg' isn't an envelope, 'size' is 0 if it's malformed.
+    static bool decompress(const ofxEasyOscMessageView& msg, vector<char>& buffer, size_t& size);
+
+protected:
+    enum State {
+        UNKNOWN,
+        PROBING,
+        SUPPORTED,
+        UNSUPPORTED
+    };
+
+    struct Channel {
+        Channel() : state(UNKNOWN), numProbes(0), lastProbe(0) {}
+        State state;
+        int numProbes;
+        int64_t lastProbe;
+    };
+
+    template <typename TSendTo>
+    void probe(Channel& channel, size_t destination, int64_t now, TSendTo&& sendTo);
+
+    vector<Channel> channels;
+    vector<char> envelope;
+    vector<uint32_t> table;
+    size_t threshold;
+    bool bNegotiate;
+    ofxEasyOscCompressionStats stats;
+};
+
+/* definitions */
+
+#define OFXEASYOSC_LZ4_HASH_BITS 12
+#define OFXEASYOSC_LZ4_MIN_MATCH 4
+// the last match must start at least 12 bytes before the end and the last 5 bytes are always literals
+#define OFXEASYOSC_LZ4_MF_LIMIT 12
+#define OFXEASYOSC_LZ4_LAST_LITERALS 5
+
+inline uint32_t ofxEasyOscLz4Read32(const char* p){
+    uint32_t value;
+    std::memcpy(&value, p, 4);
+    return value;
+}
+
+inline uint32_t ofxEasyOscLz4Hash(uint32_t value){
+    return (value * 2654435761U) >> (32 - OFXEASYOSC_LZ4_HASH_BITS);
+}
+
+// literal or match length beyond the 4 bits of the token
+inline char* ofxEasyOscLz4WriteLength(char* op, size_t length){
+    while (length >= 255){
+        *op++ = static_cast<char>(255);
+        length -= 255;
+    }
+    *op++ = static_cast<char>(length);
+    return op;
+}
+
+inline char* ofxEasyOscLz4WriteSequence(char* op, const char* literals, size_t numLiterals, size_t offset, size_t matchLength){
+    char* token = op++;
+    *token = static_cast<char>((numLiterals >= 15 ? 15 : numLiterals) << 4);
+    if (numLiterals >= 15){
+        op = ofxEasyOscLz4WriteLength(op, numLiterals - 15);
+    }
+    std::memcpy(op, literals, numLiterals);
+    op += numLiterals;
+    if (matchLength){
+        // little endian offset
+        *op++ = static_cast<char>(offset & 0xff);
+        *op++ = static_cast<char>(offset >> 8);
+        const size_t length = matchLength - OFXEASYOSC_LZ4_MIN_MATCH;
+        *token |= static_cast<char>(length >= 15 ? 15 : length);
+        if (length >= 15){
+            op = ofxEasyOscLz4WriteLength(op, length - 15);
+        }
+    }
+    return op;
+}
+
+inline size_t ofxEasyOscLz4Compress(const char* src, size_t size, char* dest, vector<uint32_t>& table){
+    char* op = dest;
+    size_t anchor = 0;
+    if (size > OFXEASYOSC_LZ4_MF_LIMIT){
+        // positions + 1 (0 = empty)
+        table.assign(size_t(1) << OFXEASYOSC_LZ4_HASH_BITS, 0);
+        const size_t matchStartLimit = size - OFXEASYOSC_LZ4_MF_LIMIT;
+        const size_t matchEndLimit = size - OFXEASYOSC_LZ4_LAST_LITERALS;
+        size_t ip = 0;
+        while (ip < matchStartLimit){
+            const uint32_t sequence = ofxEasyOscLz4Read32(src + ip);
+            uint32_t& slot = table[ofxEasyOscLz4Hash(sequence)];
+            const size_t ref = slot ? slot - 1 : ip;
+            slot = static_cast<uint32_t>(ip + 1);
+            if (ref < ip && ip - ref <= 65535 && ofxEasyOscLz4Read32(src + ref) == sequence){
+                size_t length = OFXEASYOSC_LZ4_MIN_MATCH;
+                while (ip + length < matchEndLimit && src[ref + length] == src[ip + length]){
+                    ++length;
+                }
+                op = ofxEasyOscLz4WriteSequence(op, src + anchor, ip - anchor, ip - ref, length);
+                ip += length;
+                anchor = ip;
+                // remember a position inside the match, it's likely to repeat
+                if (ip - 2 < matchStartLimit){
+                    table[ofxEasyOscLz4Hash(ofxEasyOscLz4Read32(src + ip - 2))] = static_cast<uint32_t>(ip - 2 + 1);
+                }
+            } else {
+                // skip faster through incompressible data
+                ip += 1 + ((ip - anchor) >> 6);
+            }
+        }
+    }
+    // the rest are literals
+    op = ofxEasyOscLz4WriteSequence(op, src + anchor, size - anchor, 0, 0);
+    return op - dest;
+}
+
+inline bool ofxEasyOscLz4ReadLength(const unsigned char*& ip, const unsigned char* end, size_t& length){
+    unsigned char b;
+    do {
+        if (ip >= end){
+            return false;
+        }
+        b = *ip++;
+        length += b;
+    } while (b == 255);
+    return true;
+}
+
+inline bool ofxEasyOscLz4Decompress(const char* src, size_t size, char* dest, size_t destSize){
+    const unsigned char* ip = reinterpret_cast<const unsigned char*>(src);
+    const unsigned char* end = ip + size;
+    size_t op = 0;
+    while (ip < end){
+        const unsigned char token = *ip++;
+        size_t numLiterals = token >> 4;
+        if (numLiterals == 15 && !ofxEasyOscLz4ReadLength(ip, end, numLiterals)){
+            return false;
+        }
+        if (numLiterals > size_t(end - ip) || numLiterals > destSize - op){
+            return false;
+        }
+        std::memcpy(dest + op, ip, numLiterals);
+        ip += numLiterals;
+        op += numLiterals;
+        if (ip == end){
+            break; // the last sequence has no match
+        }
+        if (end - ip < 2){
+            return false;
+        }
+        const size_t offset = ip[0] | (size_t(ip[1]) << 8);
+        ip += 2;
+        if (!offset || offset > op){
+            return false;
+        }
+        size_t length = token & 15;
+        if (length == 15 && !ofxEasyOscLz4ReadLength(ip, end, length)){
+            return false;
+        }
+        length += OFXEASYOSC_LZ4_MIN_MATCH;
+        if (length > destSize - op){
+            return false;
+        }
+        // the match may overlap the output (e.g. runs), so copy byte by byte
+        for (size_t i = 0; i < length; ++i, ++op){
+            dest[op] = dest[op - offset];
+        }
+    }
+    return op == destSize;
+}
+
+inline void ofxEasyOscCompressor::setThreshold(size_t size, bool bNegotiate_){
+    threshold = size;
+    bNegotiate = bNegotiate_;
+}
+
+inline bool ofxEasyOscCompressor::isNegotiating() const {
+    if (!isActive() || !bNegotiate){
+        return false;
+    }
+    for (auto& channel : channels){
+        if (channel.state == PROBING){
+            return true;
+        }
+    }
+    return false;
+}
+
+inline bool ofxEasyOscCompressor::isProbe(const ofxEasyOscMessageView& msg){
+    return msg.getAddressLength() == 3 && std::memcmp(msg.getAddressData(), OFXEASYOSC_COMPRESSION_PROBE, 3) == 0
+            && msg.getTypeTagsLength() == 1 && msg.getTypeTags()[0] == 'i';
+}
+
+inline void ofxEasyOscCompressor::writeProbe(char* dest){
+    std::memcpy(dest, OFXEASYOSC_COMPRESSION_PROBE, 4);
+    std::memcpy(dest + 4, ",i\0", 4);
+    ofxEasyOscWrite32(dest + 8, version);
+}
+
+template <typename TSendTo>
+inline void ofxEasyOscCompressor::probe(Channel& channel, size_t destination, int64_t now, TSendTo&& sendTo){
+    if (channel.numProbes >= maxProbes){
+        channel.state = UNSUPPORTED; // probably a plain OSC peer
+        return;
+    }
+    char message[probeSize];
+    writeProbe(message);
+    sendTo(message, probeSize, destination);
+    channel.state = PROBING;
+    channel.lastProbe = now;
+    ++channel.numProbes;
+}
+
+template <typename TSendTo>
+inline bool ofxEasyOscCompressor::compress(const char* src, size_t size, size_t destination, TSendTo&& sendTo){
+    Channel& channel = channels[destination];
+    if (bNegotiate && channel.state != SUPPORTED){
+        if (channel.state == UNKNOWN){
+            probe(channel, destination, ofxEasyOscRateLimiter::now(), sendTo);
+        }
+        ++stats.numUncompressed;
+        return false;
+    }
+    // "/#z" ",ib" original size, blob size, blob (padded)
+    envelope.resize(16 + ofxEasyOscLz4Bound(size) + 3);
+    const size_t compressed = ofxEasyOscLz4Compress(src, size, envelope.data() + 16, table);
+    const size_t padded = (compressed + 3) & ~size_t(3);
+    if (16 + padded >= size){
+        ++stats.numUncompressed;
+        return false;
+    }
+    char* p = envelope.data();
+    std::memcpy(p, OFXEASYOSC_COMPRESSED_ADDRESS, 4);
+    std::memcpy(p + 4, ",ib", 4);
+    ofxEasyOscWrite32(p + 8, static_cast<uint32_t>(size));
+    ofxEasyOscWrite32(p + 12, static_cast<uint32_t>(compressed));
+    std::memset(p + 16 + compressed, 0, padded - compressed);
+    envelope.resize(16 + padded);
+    ++stats.numCompressed;
+    stats.numBytesIn += size;
+    stats.numBytesOut += envelope.size();
+    return true;
+}
+
+inline bool ofxEasyOscCompressor::receive(const ofxEasyOscMessageView& msg, size_t destination){
+    if (!isProbe(msg)){
+        return false;
+    }
+    if (destination < channels.size() && msg.getArgAsInt32(0) == version){
+        channels[destination].state = SUPPORTED;
+    }
+    return true;
+}
+
+template <typename TSendTo>
+inline void ofxEasyOscCompressor::update(TSendTo&& sendTo){
+    int64_t now = 0;
+    for (size_t i = 0; i < channels.size(); ++i){
+        if (channels[i].state == PROBING){
+            if (!now){
+                now = ofxEasyOscRateLimiter::now();
+            }
+            // one probe per second
+            if (now - channels[i].lastProbe >= 1000000000){
+                probe(channels[i], i, now, sendTo);
+            }
+        }
+    }
+}
+
+inline bool ofxEasyOscCompressor::decompress(const ofxEasyOscMessageView& msg, vector<char>& buffer, size_t& size){
+    if (!(msg.getAddressLength() == 3 && std::memcmp(msg.getAddressData(), OFXEASYOSC_COMPRESSED_ADDRESS, 3) == 0
+            && msg.getTypeTagsLength() == 2 && std::memcmp(msg.getTypeTags(), "ib", 2) == 0)){
+        return false;
+    }
+    size = 0;
+    const uint32_t original = static_cast<uint32_t>(msg.getArgAsInt32(0));
+    const char* blob;
+    size_t blobSize;
+    // a UDP datagram can't be larger than 64 KB
+    if (original && original <= 65536 && msg.getArgAsBlob(1, blob, blobSize)){
+        if (buffer.size() < original){
+            buffer.resize(original);
+        }
+        if (ofxEasyOscLz4Decompress(blob, blobSize, buffer.data(), original)){
+            size = original;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,398 @@
+#pragma once
+
+#include "ofxEasyOscAdapter.h"
+#include "ofxEasyOscCodec.h"
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+/// Delta encoding for large, slowly changing messages (see ofxEasyOscSender::setDelta()).
+///
+/// The sender keeps the last message of every delta address. If the new message has the same size and type tags,
+/// only the changed 32-bit words are sent as a "/#d" message: the address (string), the frame number (int32) and a blob with
+/// the number of words (uint32), a bit mask of the changed words (uint32 per 32 words, LSB first) and the changed words.
+/// Every Nth message (and whenever the layout changes or a delta wouldn't be smaller) is sent in full as a keyframe:
+/// a bundle whose first element is a "/#k" message with the frame number, followed by the message itself.
+///
+/// ofxEasyOscReceiver keeps the last message per registered address and source, patches it and dispatches the result as an ordinary message.
+/// A delta only applies to the frame right before it, so after a lost datagram the receiver waits for the next keyframe.
+/// Plain OSC peers only see the keyframes (and an extra "/#k" message).
+
+// address of the keyframe header
+#define OFXEASYOSC_KEYFRAME_ADDRESS "/#k"
+// address of the delta message
+#define OFXEASYOSC_DELTA_ADDRESS "/#d"
+
+struct ofxEasyOscDeltaStats {
+    ofxEasyOscDeltaStats() : numKeyframes(0), numDeltas(0), numBytesIn(0), numBytesOut(0), numPatched(0), numMissed(0) {}
+
+    // sender
+    uint64_t numKeyframes;
+    uint64_t numDeltas;
+    uint64_t numBytesIn; // size of the messages
+    uint64_t numBytesOut; // size of the keyframes and deltas
+    // receiver
+    uint64_t numPatched;
+    uint64_t numMissed; // deltas without a matching base (lost datagram, no keyframe yet or malformed)
+};
+
+//*-------------------------------------------------------------------------------------------------------*//
+/// ofxEasyOscDeltaEncoder
+
+/// Delta state of ofxEasyOscSender, per address (the same for all destinations).
+
+class ofxEasyOscDeltaEncoder {
+public:
+    // keyframe bundle header: "#bundle", time tag, size, "/#k" ",i" frame, size of the message
+    static const size_t overhead = 16 + 4 + 12 + 4;
+
+    // send a keyframe every 'keyframeInterval' messages of the address (at least 1)
+    void add(const string& address, int keyframeInterval);
+    void clear() { entries.clear(); }
+    bool isActive() const { return !entries.empty(); }
+    // the next message of every address is a keyframe (e.g. for a new destination)
+    void requestKeyframes();
+
+    // returns false if the address isn't delta encoded, otherwise the keyframe/delta is in data()/size() (valid until the next call)
+    bool encode(const char* src, size_t size, const char* address, size_t length);
+    const char* data() const { return packet.data(); }
+    size_t size() const { return packet.size(); }
+
+    const ofxEasyOscDeltaStats& getStats() const { return stats; }
+
+protected:
+    struct Entry {
+        string address;
+        int interval;
+        int count; // messages since the last keyframe
+        uint32_t frame;
+        vector<char> last;
+    };
+
+    void writeKeyframe(Entry& entry, const char* src, size_t size);
+    // returns false if the delta wouldn't be smaller than the message
+    bool writeDelta(Entry& entry, const char* src, size_t size);
+
+    vector<Entry> entries;
+    vector<char> packet;
+    vector<uint32_t> mask;
+    ofxEasyOscDeltaStats stats;
+};
+
+// the address of the message an encoded packet stands for: a plain message, a "/#d" message or a keyframe bundle
+inline const char* ofxEasyOscDeltaAddress(const char* data, size_t size, size_t& length){
+    if (size >= ofxEasyOscDeltaEncoder::overhead && std::memcmp(data, "#bundle", 8) == 0
+            && std::memcmp(data + 20, OFXEASYOSC_KEYFRAME_ADDRESS, 4) == 0){
+        data += ofxEasyOscDeltaEncoder::overhead;
+        size -= ofxEasyOscDeltaEncoder::overhead;
+    } else if (size > 12 && std::memcmp(data, OFXEASYOSC_DELTA_ADDRESS, 4) == 0){
+        data += 12;
+        size -= 12;
+    }
+    const char* end = static_cast<const char*>(std::memchr(data, 0, size));
+    length = end ? end - data : size;
+    return data;
+}
+
+//*-------------------------------------------------------------------------------------------------------*//
+/// ofxEasyOscDeltaDecoder
+
+/// Delta state of ofxEasyOscReceiver, per address and source. The receiver only passes keyframes of registered addresses,
+/// and every address keeps at most 'maxSources' bases (the least recently used one is replaced), so spoofed keyframes can't
+/// make it grow without bounds.
+
+class ofxEasyOscDeltaDecoder {
+public:
+    static const size_t maxSources = 4;
+
+    ofxEasyOscDeltaDecoder() : tick(0) {}
+
+    // parse a "/#k" message. returns false if it isn't one.
+    static bool readKeyframe(const ofxEasyOscMessageView& msg, uint32_t& frame);
+    // the message which followed a "/#k" header becomes the new base of its address
+    void keyframe(const ofxEasyOscMessageView& msg, uint32_t frame);
+    // apply a "/#d" message to its base. returns false if 'msg' isn't one, 'size' is 0 if it can't be applied.
+    // otherwise the patched message is in 'buffer'.
+    bool patch(const ofxEasyOscMessageView& msg, vector<char>& buffer, size_t& size);
+
+    const ofxEasyOscDeltaStats& getStats() const { return stats; }
+
+    void clear() { bases.clear(); }
+    // forget the bases of an address (e.g. after it has been unregistered)
+    void remove(const string& address) { bases.erase(address); }
+
+protected:
+    struct Base {
+        ofxEasyOscEndpoint from;
+        uint32_t frame;
+        bool bValid; // false after a gap until the next keyframe
+        uint64_t lastUse;
+        vector<char> message;
+    };
+
+    // returns nullptr if there is no base (and 'bCreate' is false)
+    Base* find(const char* address, size_t length, const ofxEasyOscEndpoint& from, bool bCreate);
+
+    unordered_map<string, vector<Base>> bases;
+    string key; // reused for the lookup
+    uint64_t tick;
+    ofxEasyOscDeltaStats stats;
+};
+
+/* definitions */
+
+inline void ofxEasyOscDeltaEncoder::add(const string& address, int keyframeInterval){
+    for (auto& entry : entries){
+        if (entry.address == address){
+            entry.interval = keyframeInterval > 1 ? keyframeInterval : 1;
+            return;
+        }
+    }
+    Entry entry;
+    entry.address = address;
+    entry.interval = keyframeInterval > 1 ? keyframeInterval : 1;
+    entry.count = 0;
+    // a restarted sender doesn't continue the frames of its predecessor
+    std::random_device random;
+    entry.frame = random();
+    entries.push_back(std::move(entry));
+}
+
+inline void ofxEasyOscDeltaEncoder::requestKeyframes(){
+    for (auto& entry : entries){
+        entry.last.clear();
+    }
+}
+
+inline bool ofxEasyOscDeltaEncoder::encode(const char* src, size_t size, const char* address, size_t length){
+    // usually there are only a handful of delta addresses
+    for (auto& entry : entries){
+        if (entry.address.size() == length && std::memcmp(entry.address.data(), address, length) == 0){
+            ++entry.frame;
+            // the layout (address and type tags) is part of the compared words, so a changed layout changes the size
+            // or shows up in the first words. both are rare, so a keyframe is fine.
+            if (entry.last.size() != size || ++entry.count >= entry.interval || !writeDelta(entry, src, size)){
+                writeKeyframe(entry, src, size);
+            }
+            stats.numBytesIn += size;
+            stats.numBytesOut += packet.size();
+            return true;
+        }
+    }
+    return false;
+}
+
+inline void ofxEasyOscDeltaEncoder::writeKeyframe(Entry& entry, const char* src, size_t size){
+    packet.resize(overhead + size);
+    char* dest = packet.data();
+    std::memcpy(dest, "#bundle", 8);
+    ofxEasyOscWrite64(dest + 8, 1);
+    ofxEasyOscWrite32(dest + 16, 12);
+    std::memcpy(dest + 20, OFXEASYOSC_KEYFRAME_ADDRESS, 4);
+    std::memcpy(dest + 24, ",i\0", 4);
+    ofxEasyOscWrite32(dest + 28, entry.frame);
+    ofxEasyOscWrite32(dest + 32, static_cast<uint32_t>(size));
+    std::memcpy(dest + overhead, src, size);
+    entry.last.assign(src, src + size);
+    entry.count = 0;
+    ++stats.numKeyframes;
+}
+
+inline bool ofxEasyOscDeltaEncoder::writeDelta(Entry& entry, const char* src, size_t size){
+    // OSC messages are a multiple of 4 bytes
+    const size_t numWords = size / 4;
+    const size_t numMasks = (numWords + 31) / 32;
+    mask.assign(numMasks, 0);
+    // compare 8 words at a time. the XOR/OR loop is branch free with a fixed trip count, so the compiler vectorizes it;
+    // only groups with changes are looked at word by word.
+    const char* last = entry.last.data();
+    size_t numChanged = 0;
+    for (size_t m = 0; m < numMasks; ++m){
+        const size_t end = numWords - m * 32 < 32 ? numWords : (m + 1) * 32;
+        uint32_t bits = 0;
+        for (size_t first = m * 32; first < end; first += 8){
+            if (end - first >= 8){
+                uint32_t any = 0;
+                for (size_t i = first; i < first + 8; ++i){
+                    uint32_t a, b;
+                    std::memcpy(&a, src + i * 4, 4);
+                    std::memcpy(&b, last + i * 4, 4);
+                    any |= a ^ b;
+                }
+                if (!any){
+                    continue;
+                }
+            }
+            for (size_t i = first; i < end && i < first + 8; ++i){
+                uint32_t a, b;
+                std::memcpy(&a, src + i * 4, 4);
+                std::memcpy(&b, last + i * 4, 4);
+                bits |= uint32_t(a != b) << (i - m * 32);
+            }
+        }
+        mask[m] = bits;
+        // popcount
+        uint32_t v = bits - ((bits >> 1) & 0x55555555);
+        v = (v & 0x33333333) + ((v >> 2) & 0x33333333);
+        numChanged += (((v + (v >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+    }
+    // "/#d" ",sib" address frame blob(numWords, masks, words)
+    const size_t addressSize = (entry.address.size() + 4) & ~size_t(3);
+    const size_t blobSize = 4 + numMasks * 4 + numChanged * 4;
+    const size_t deltaSize = 12 + addressSize + 8 + blobSize;
+    if (deltaSize >= size){
+        return false;
+    }
+    packet.assign(deltaSize, 0);
+    char* dest = packet.data();
+    std::memcpy(dest, OFXEASYOSC_DELTA_ADDRESS, 4);
+    std::memcpy(dest + 4, ",sib", 4);
+    std::memcpy(dest + 12, entry.address.data(), entry.address.size());
+    dest += 12 + addressSize;
+    ofxEasyOscWrite32(dest, entry.frame);
+    ofxEasyOscWrite32(dest + 4, static_cast<uint32_t>(blobSize));
+    ofxEasyOscWrite32(dest + 8, static_cast<uint32_t>(numWords));
+    dest += 12;
+    for (size_t m = 0; m < numMasks; ++m){
+        ofxEasyOscWrite32(dest, mask[m]);
+        dest += 4;
+    }
+    // the words are copied as they are (already big endian)
+    for (size_t m = 0; m < numMasks; ++m){
+        size_t i = m * 32;
+        for (uint32_t bits = mask[m]; bits; bits >>= 1, ++i){
+            if (bits & 1){
+                std::memcpy(dest, src + i * 4, 4);
+                dest += 4;
+            }
+        }
+    }
+    std::memcpy(entry.last.data(), src, size);
+    ++stats.numDeltas;
+    return true;
+}
+
+inline bool ofxEasyOscDeltaDecoder::readKeyframe(const ofxEasyOscMessageView& msg, uint32_t& frame){
+    if (msg.getAddressLength() == 3 && std::memcmp(msg.getAddressData(), OFXEASYOSC_KEYFRAME_ADDRESS, 3) == 0
+            && msg.getTypeTagsLength() == 1 && msg.getTypeTags()[0] == 'i'){
+        frame = static_cast<uint32_t>(msg.getArgAsInt32(0));
+        return true;
+    }
+    return false;
+}
+
+inline ofxEasyOscDeltaDecoder::Base* ofxEasyOscDeltaDecoder::find(const char* address, size_t length,
+                                                                  const ofxEasyOscEndpoint& from, bool bCreate){
+    key.assign(address, length);
+    auto it = bases.find(key);
+    if (it == bases.end()){
+        if (!bCreate){
+            return nullptr;
+        }
+        it = bases.emplace(key, vector<Base>()).first;
+    }
+    vector<Base>& sources = it->second;
+    Base* oldest = nullptr;
+    for (auto& base : sources){
+        if (base.from == from){
+            base.lastUse = ++tick;
+            return &base;
+        }
+        if (!oldest || base.lastUse < oldest->lastUse){
+            oldest = &base;
+        }
+    }
+    if (!bCreate){
+        return nullptr;
+    }
+    Base* base = oldest;
+    if (sources.size() < maxSources){
+        sources.emplace_back();
+        base = &sources.back();
+    }
+    base->from = from;
+    base->bValid = false;
+    base->lastUse = ++tick;
+    return base;
+}
+
+inline void ofxEasyOscDeltaDecoder::keyframe(const ofxEasyOscMessageView& msg, uint32_t frame){
+    Base* base = find(msg.getAddressData(), msg.getAddressLength(), msg.getRemoteEndpoint(), true);
+    if (base->bValid && static_cast<int32_t>(frame - base->frame) <= 0){
+        // a late keyframe must not replace a newer base
+        return;
+    }
+    base->frame = frame;
+    base->bValid = true;
+    base->message.assign(msg.getData(), msg.getData() + msg.getSize());
+}
+
+inline bool ofxEasyOscDeltaDecoder::patch(const ofxEasyOscMessageView& msg, vector<char>& buffer, size_t& size){
+    if (!(msg.getAddressLength() == 3 && std::memcmp(msg.getAddressData(), OFXEASYOSC_DELTA_ADDRESS, 3) == 0
+            && msg.getTypeTagsLength() == 3 && std::memcmp(msg.getTypeTags(), "sib", 3) == 0)){
+        return false;
+    }
+    size = 0;
+    size_t length;
+    const char* address = msg.getArgAsCString(0, &length);
+    const uint32_t frame = static_cast<uint32_t>(msg.getArgAsInt32(1));
+    const char* blob;
+    size_t blobSize;
+    Base* base = address ? find(address, length, msg.getRemoteEndpoint(), false) : nullptr;
+    if (!base || !base->bValid || !msg.getArgAsBlob(2, blob, blobSize)){
+        ++stats.numMissed;
+        return true;
+    }
+    const int32_t diff = static_cast<int32_t>(frame - base->frame);
+    if (diff <= 0){
+        // duplicated or late, the base is already newer
+        ++stats.numMissed;
+        return true;
+    }
+    if (diff > 1){
+        // a frame is missing, wait for the next keyframe
+        base->bValid = false;
+        ++stats.numMissed;
+        return true;
+    }
+    const size_t numWords = base->message.size() / 4;
+    const size_t numMasks = (numWords + 31) / 32;
+    if (blobSize < 4 + numMasks * 4 || ofxEasyOscRead32(blob) != numWords){
+        ++stats.numMissed;
+        return true;
+    }
+    const char* masks = blob + 4;
+    const char* words = masks + numMasks * 4;
+    const char* end = blob + blobSize;
+    char* dest = base->message.data();
+    for (size_t m = 0; m < numMasks; ++m){
+        uint32_t bits = ofxEasyOscRead32(masks + m * 4);
+        // ignore bits beyond the last word
+        if (numWords - m * 32 < 32){
+            bits &= (uint32_t(1) << (numWords - m * 32)) - 1;
+        }
+        for (size_t i = m * 32; bits; bits >>= 1, ++i){
+            if (bits & 1){
+                if (words + 4 > end){
+                    // malformed, the base is corrupted now
+                    base->bValid = false;
+                    ++stats.numMissed;
+                    return true;
+                }
+                std::memcpy(dest + i * 4, words, 4);
+                words += 4;
+            }
+        }
+    }
+    base->frame = frame;
+    // the listeners get a copy, so they can't disturb the base
+    if (buffer.size() < base->message.size()){
+        buffer.resize(base->message.size());
+    }
+    std::memcpy(buffer.data(), base->message.data(), base->message.size());
+    size = base->message.size();
+    ++stats.numPatched;
+    return true;
+}
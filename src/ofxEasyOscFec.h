@@ -0,0 +1,378 @@
+#pragma once
+
+#include "ofxEasyOscAdapter.h"
+#include "ofxEasyOscCodec.h"
+#include "ofxEasyOscSocket.h"
+#include "ofxEasyOscRateLimiter.h"
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+/// Forward error correction with XOR parity (see ofxEasyOscSender::setForwardErrorCorrection()).
+///
+/// The sender splits the datagrams of every destination into groups of K. Each datagram is wrapped in a bundle whose first element
+/// is a "/#f" message with three int32 arguments (stream id, group, index in the group), followed by the original datagram.
+/// After K datagrams (or when update() finds an incomplete group older than the flush interval) the sender emits a "/#p" message
+/// with the stream id, the group, the number of datagrams in the group, the XOR of their sizes and a blob with the XOR of their contents.
+/// The receiver can rebuild any single lost datagram of a group without a round trip, at the cost of 1/K extra packets.
+/// Two or more losses in the same group can't be recovered.
+///
+/// The receiver doesn't store the datagrams of a group, it only XORs everything which arrives (data and parity) into an accumulator:
+/// once the parity and all but one datagram have arrived, the accumulator *is* the missing datagram.
+/// Recovered datagrams arrive late, so with sequence numbers they are counted as reordered (and discarded by OFXEASYOSC_LATE_DISCARD).
+
+// address of the header message
+#define OFXEASYOSC_FEC_ADDRESS "/#f"
+// address of the parity message
+#define OFXEASYOSC_PARITY_ADDRESS "/#p"
+
+struct ofxEasyOscFecStats {
+    ofxEasyOscFecStats() : numData(0), numParity(0), numParityBytes(0), numRecovered(0), numUnrecovered(0) {}
+
+    // sender
+    uint64_t numData; // datagrams
+    uint64_t numParity; // parity packets
+    uint64_t numParityBytes; // bandwidth spent on parity packets
+    // receiver
+    uint64_t numRecovered; // lost datagrams which have been rebuilt
+    uint64_t numUnrecovered; // datagrams lost in groups with more than one loss (only known once the parity has arrived)
+};
+
+//*-------------------------------------------------------------------------------------------------------*//
+/// ofxEasyOscFecEncoder
+
+/// Parity generation of ofxEasyOscSender. sendTo(data, size, destination) sends a datagram to a destination.
+
+class ofxEasyOscFecEncoder {
+public:
+    // the receiver keeps track of the group with a 32 bit mask
+    static const size_t maxGroupSize = 32;
+    // bundle header + header message + size of the wrapped element
+    static const size_t overhead = 16 + 4 + 24 + 4;
+
+    ofxEasyOscFecEncoder() : groupSize(0), stream(0), flushInterval(10000000) {}
+
+    // number of datagrams per parity packet (0 = off)
+    void setGroupSize(size_t numDatagrams);
+    size_t getGroupSize() const { return groupSize; }
+    bool isActive() const { return groupSize > 0; }
+    // incomplete groups are closed by update() after this time
+    void setFlushInterval(double ms) { flushInterval = static_cast<int64_t>(ms * 1000000); }
+    double getFlushInterval() const { return flushInterval * 1e-6; }
+
+    // (re)set the number of destinations
+    void resize(size_t numDestinations) { channels.resize(numDestinations); }
+    // forget all destinations and their incomplete groups. the group numbers start again with a new stream id.
+    void reset();
+
+    template <typename TSendTo>
+    void send(const char* data, size_t size, size_t destination, TSendTo&& sendTo);
+    // send the parity of incomplete groups
+    template <typename TSendTo>
+    void update(TSendTo&& sendTo);
+
+    const ofxEasyOscFecStats& getStats() const { return stats; }
+
+protected:
+    struct Channel {
+        Channel() : group(0), count(0), lengths(0), first(0) {}
+        uint32_t group;
+        uint32_t count; // datagrams in the current group
+        uint32_t lengths; // XOR of their sizes
+        vector<char> parity; // XOR of their contents
+        int64_t first; // time of the first datagram
+    };
+
+    template <typename TSendTo>
+    void sendParity(Channel& channel, size_t destination, TSendTo&& sendTo);
+
+    vector<Channel> channels;
+    vector<char> packet; // reused for wrapping
+    size_t groupSize;
+    uint32_t stream;
+    int64_t flushInterval; // nanoseconds
+    ofxEasyOscFecStats stats;
+};
+
+//*-------------------------------------------------------------------------------------------------------*//
+/// ofxEasyOscFecDecoder
+
+/// Recovery of ofxEasyOscReceiver, per source (remote endpoint). Keeps the last few groups of every source.
+
+class ofxEasyOscFecDecoder {
+public:
+    static const size_t numGroups = 8;
+
+    ofxEasyOscFecDecoder() : lastIndex(0) {}
+
+    // returns false if the datagram doesn't belong to the FEC layer. otherwise process(data, size) is called with the
+    // original datagram (nothing for parity packets and duplicates) and with every datagram which could be recovered.
+    template <typename TProcess>
+    bool decode(const char* data, size_t size, const ofxEasyOscEndpoint& from, TProcess&& process);
+
+    const ofxEasyOscFecStats& getStats() const { return stats; }
+
+    void clear();
+
+protected:
+    struct Group {
+        Group() : id(0), mask(0), count(0), lengths(0), bUsed(false) {}
+        uint32_t id;
+        uint32_t mask; // datagrams which have arrived (or have been recovered)
+        uint32_t count; // number of datagrams (0 until the parity has arrived)
+        uint32_t lengths;
+        vector<char> accumulator;
+        bool bUsed;
+    };
+
+    struct Source {
+        ofxEasyOscEndpoint from;
+        uint32_t stream;
+        Group groups[numGroups];
+    };
+
+    Source& lookup(const ofxEasyOscEndpoint& from, uint32_t stream);
+    // returns nullptr if the group is too old
+    Group* getGroup(Source& source, uint32_t id);
+    void accumulate(Group& group, const char* data, size_t size, uint32_t lengths);
+    template <typename TProcess>
+    void recover(Group& group, TProcess&& process);
+
+    vector<Source> sources;
+    size_t lastIndex;
+    ofxEasyOscFecStats stats;
+};
+
+/* definitions */
+
+inline void ofxEasyOscFecEncoder::setGroupSize(size_t numDatagrams){
+    groupSize = numDatagrams > maxGroupSize ? size_t(maxGroupSize) : numDatagrams;
+    if (groupSize && !stream){
+        std::random_device random;
+        stream = random() | 1; // never 0
+    }
+    // start with fresh groups. the group numbers keep counting (an incomplete group is skipped), receivers would take
+    // a reused number for an old group.
+    for (auto& channel : channels){
+        if (channel.count){
+            ++channel.group;
+        }
+        channel.count = 0;
+        channel.lengths = 0;
+        channel.parity.clear();
+    }
+}
+
+inline void ofxEasyOscFecEncoder::reset(){
+    channels.clear();
+    if (stream){
+        std::random_device random;
+        stream = random() | 1;
+    }
+}
+
+template <typename TSendTo>
+inline void ofxEasyOscFecEncoder::send(const char* data, size_t size, size_t destination, TSendTo&& sendTo){
+    Channel& channel = channels[destination];
+    // "#bundle", time tag 1 (immediately), size of the header message, "/#f" ",iii" stream group index, size of the datagram
+    packet.resize(overhead + size);
+    char* p = packet.data();
+    std::memcpy(p, "#bundle", 8);
+    ofxEasyOscWrite64(p + 8, 1);
+    ofxEasyOscWrite32(p + 16, 24);
+    std::memcpy(p + 20, OFXEASYOSC_FEC_ADDRESS, 4);
+    std::memcpy(p + 24, ",iii\0\0\0", 8);
+    ofxEasyOscWrite32(p + 32, stream);
+    ofxEasyOscWrite32(p + 36, channel.group);
+    ofxEasyOscWrite32(p + 40, channel.count);
+    ofxEasyOscWrite32(p + 44, static_cast<uint32_t>(size));
+    std::memcpy(p + overhead, data, size);
+    sendTo(packet.data(), packet.size(), destination);
+    ++stats.numData;
+
+    if (!channel.count){
+        channel.first = ofxEasyOscRateLimiter::now();
+    }
+    if (channel.parity.size() < size){
+        channel.parity.resize(size, 0);
+    }
+    for (size_t i = 0; i < size; ++i){
+        channel.parity[i] ^= data[i];
+    }
+    channel.lengths ^= static_cast<uint32_t>(size);
+    if (++channel.count >= groupSize){
+        sendParity(channel, destination, sendTo);
+    }
+}
+
+template <typename TSendTo>
+inline void ofxEasyOscFecEncoder::sendParity(Channel& channel, size_t destination, TSendTo&& sendTo){
+    // "/#p" ",iiiib" stream group count lengths, blob
+    const size_t blobSize = channel.parity.size();
+    packet.assign(32 + ((blobSize + 3) & ~size_t(3)), 0);
+    char* p = packet.data();
+    std::memcpy(p, OFXEASYOSC_PARITY_ADDRESS, 4);
+    std::memcpy(p + 4, ",iiiib", 6);
+    ofxEasyOscWrite32(p + 12, stream);
+    ofxEasyOscWrite32(p + 16, channel.group);
+    ofxEasyOscWrite32(p + 20, channel.count);
+    ofxEasyOscWrite32(p + 24, channel.lengths);
+    ofxEasyOscWrite32(p + 28, static_cast<uint32_t>(blobSize));
+    std::memcpy(p + 32, channel.parity.data(), blobSize);
+    sendTo(packet.data(), packet.size(), destination);
+    ++stats.numParity;
+    stats.numParityBytes += packet.size();
+
+    // next group (keep the capacity)
+    ++channel.group;
+    channel.count = 0;
+    channel.lengths = 0;
+    channel.parity.clear();
+}
+
+template <typename TSendTo>
+inline void ofxEasyOscFecEncoder::update(TSendTo&& sendTo){
+    int64_t now = 0;
+    for (size_t i = 0; i < channels.size(); ++i){
+        if (channels[i].count){
+            if (!now){
+                now = ofxEasyOscRateLimiter::now();
+            }
+            if (now - channels[i].first >= flushInterval){
+                sendParity(channels[i], i, sendTo);
+            }
+        }
+    }
+}
+
+inline ofxEasyOscFecDecoder::Source& ofxEasyOscFecDecoder::lookup(const ofxEasyOscEndpoint& from, uint32_t stream){
+    Source* source = nullptr;
+    if (lastIndex < sources.size() && sources[lastIndex].from == from){
+        source = &sources[lastIndex];
+    } else {
+        for (size_t i = 0; i < sources.size(); ++i){
+            if (sources[i].from == from){
+                lastIndex = i;
+                source = &sources[i];
+                break;
+            }
+        }
+        if (!source){
+            sources.emplace_back();
+            lastIndex = sources.size() - 1;
+            source = &sources.back();
+            source->from = from;
+            source->stream = stream;
+        }
+    }
+    // a new stream (the sender has been restarted)
+    if (source->stream != stream){
+        source->stream = stream;
+        for (auto& group : source->groups){
+            group.bUsed = false;
+        }
+    }
+    return *source;
+}
+
+inline ofxEasyOscFecDecoder::Group* ofxEasyOscFecDecoder::getGroup(Source& source, uint32_t id){
+    Group& group = source.groups[id % numGroups];
+    if (group.bUsed && group.id == id){
+        return &group;
+    }
+    if (group.bUsed && static_cast<int32_t>(id - group.id) < 0){
+        return nullptr;
+    }
+    // a newer group takes the slot
+    if (group.bUsed && group.count){
+        const uint32_t numArrived = static_cast<uint32_t>(std::bitset<32>(group.mask).count());
+        if (numArrived < group.count){
+            stats.numUnrecovered += group.count - numArrived;
+        }
+    }
+    group.id = id;
+    group.mask = 0;
+    group.count = 0;
+    group.lengths = 0;
+    group.accumulator.clear(); // keeps the capacity
+    group.bUsed = true;
+    return &group;
+}
+
+inline void ofxEasyOscFecDecoder::accumulate(Group& group, const char* data, size_t size, uint32_t lengths){
+    if (group.accumulator.size() < size){
+        group.accumulator.resize(size, 0);
+    }
+    for (size_t i = 0; i < size; ++i){
+        group.accumulator[i] ^= data[i];
+    }
+    group.lengths ^= lengths;
+}
+
+template <typename TProcess>
+inline void ofxEasyOscFecDecoder::recover(Group& group, TProcess&& process){
+    if (!group.count){
+        return;
+    }
+    const uint32_t all = group.count >= 32 ? 0xffffffff : (uint32_t(1) << group.count) - 1;
+    const uint32_t missing = all & ~group.mask;
+    // exactly one datagram missing
+    if (missing && !(missing & (missing - 1))){
+        group.mask |= missing;
+        if (group.lengths <= group.accumulator.size()){
+            ++stats.numRecovered;
+            process(group.accumulator.data(), static_cast<size_t>(group.lengths));
+        }
+    }
+}
+
+template <typename TProcess>
+inline bool ofxEasyOscFecDecoder::decode(const char* data, size_t size, const ofxEasyOscEndpoint& from, TProcess&& process){
+    if (size >= ofxEasyOscFecEncoder::overhead && std::memcmp(data, "#bundle", 8) == 0
+            && std::memcmp(data + 20, OFXEASYOSC_FEC_ADDRESS "\0,iii", 8) == 0){
+        const uint32_t stream = ofxEasyOscRead32(data + 32);
+        const uint32_t id = ofxEasyOscRead32(data + 36);
+        const uint32_t index = ofxEasyOscRead32(data + 40);
+        const size_t length = std::min<size_t>(ofxEasyOscRead32(data + 44), size - ofxEasyOscFecEncoder::overhead);
+        const char* payload = data + ofxEasyOscFecEncoder::overhead;
+        Group* group = index < 32 ? getGroup(lookup(from, stream), id) : nullptr;
+        if (!group){
+            // too old for recovery, but still a valid datagram
+            process(payload, length);
+            return true;
+        }
+        const uint32_t bit = uint32_t(1) << index;
+        if (group->mask & bit){
+            return true; // duplicate or already recovered
+        }
+        group->mask |= bit;
+        accumulate(*group, payload, length, static_cast<uint32_t>(length));
+        process(payload, length);
+        recover(*group, process);
+        return true;
+    }
+    if (size >= 32 && std::memcmp(data, OFXEASYOSC_PARITY_ADDRESS "\0,iiiib", 10) == 0){
+        const uint32_t stream = ofxEasyOscRead32(data + 12);
+        const uint32_t id = ofxEasyOscRead32(data + 16);
+        const uint32_t count = ofxEasyOscRead32(data + 20);
+        const uint32_t lengths = ofxEasyOscRead32(data + 24);
+        const size_t blobSize = std::min<size_t>(ofxEasyOscRead32(data + 28), size - 32);
+        Group* group = getGroup(lookup(from, stream), id);
+        if (group && !group->count && count && count <= 32){
+            group->count = count;
+            accumulate(*group, data + 32, blobSize, lengths);
+            recover(*group, process);
+        }
+        return true;
+    }
+    return false;
+}
+
+inline void ofxEasyOscFecDecoder::clear(){
+    sources.clear();
+    lastIndex = 0;
+    stats = ofxEasyOscFecStats();
+}
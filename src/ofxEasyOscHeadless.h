@@ -0,0 +1,222 @@
+#pragma once
+
+/// Minimal stand-ins for the openFrameworks types used by ofxEasyOsc (see ofxEasyOscAdapter.h).
+/// Only included when OFXEASYOSC_HEADLESS is defined. The classes have the same names and the same
+/// (reduced) interface as their openFrameworks counterparts, so code written against the addon compiles unchanged.
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <sstream>
+#include <memory>
+#include <functional>
+#include <cstring>
+#include <cstdint>
+
+// ofMain.h does the same and the addon relies on it
+using namespace std;
+
+//*-------------------------------------------------------------------------------------------------------*//
+/// vectors and matrices (data only, no math)
+
+class ofVec2f {
+public:
+    ofVec2f(float x_ = 0, float y_ = 0) : x(x_), y(y_) {}
+    float x, y;
+};
+
+class ofVec3f {
+public:
+    ofVec3f(float x_ = 0, float y_ = 0, float z_ = 0) : x(x_), y(y_), z(z_) {}
+    float x, y, z;
+};
+
+class ofVec4f {
+public:
+    ofVec4f(float x_ = 0, float y_ = 0, float z_ = 0, float w_ = 0) : x(x_), y(y_), z(z_), w(w_) {}
+    float x, y, z, w;
+};
+
+class ofMatrix3x3 {
+public:
+    ofMatrix3x3(float _a = 0, float _b = 0, float _c = 0,
+                float _d = 0, float _e = 0, float _f = 0,
+                float _g = 0, float _h = 0, float _i = 0)
+        : a(_a), b(_b), c(_c), d(_d), e(_e), f(_f), g(_g), h(_h), i(_i) {}
+    float& operator[](const int& index) { return (&a)[index]; }
+    const float& operator[](const int& index) const { return (&a)[index]; }
+    float a, b, c, d, e, f, g, h, i;
+};
+
+class ofMatrix4x4 {
+public:
+    ofMatrix4x4() { std::memset(_mat, 0, sizeof(_mat)); }
+    float* getPtr() { return &_mat[0][0]; }
+    const float* getPtr() const { return &_mat[0][0]; }
+    float _mat[4][4];
+};
+
+//*-------------------------------------------------------------------------------------------------------*//
+/// ofBuffer (blob storage)
+
+class ofBuffer {
+public:
+    ofBuffer() {}
+    ofBuffer(const char* buffer, std::size_t size) : buf(buffer, buffer + size) {}
+    void set(const char* buffer, std::size_t size) { buf.assign(buffer, buffer + size); }
+    char* getData() { return buf.data(); }
+    const char* getData() const { return buf.data(); }
+    std::size_t size() const { return buf.size(); }
+    void clear() { buf.clear(); }
+protected:
+    std::vector<char> buf;
+};
+
+//*-------------------------------------------------------------------------------------------------------*//
+/// utilities
+
+template <typename T>
+inline std::string ofToString(const T& value){
+    std::ostringstream out;
+    out << value;
+    return out.str();
+}
+
+// ofLogError("module") << "message"; prints a single line to stderr
+class ofxEasyOscLog {
+public:
+    ofxEasyOscLog(const char* level, const std::string& module) { out << "[" << level << "] " << module << ": "; }
+    ~ofxEasyOscLog() { out << "\n"; std::cerr << out.str(); }
+    template <typename T>
+    ofxEasyOscLog& operator<<(const T& value) { out << value; return *this; }
+protected:
+    std::ostringstream out;
+};
+
+class ofLogNotice : public ofxEasyOscLog {
+public:
+    ofLogNotice(const std::string& module) : ofxEasyOscLog("notice", module) {}
+};
+
+class ofLogWarning : public ofxEasyOscLog {
+public:
+    ofLogWarning(const std::string& module) : ofxEasyOscLog("warning", module) {}
+};
+
+class ofLogError : public ofxEasyOscLog {
+public:
+    ofLogError(const std::string& module) : ofxEasyOscLog("error", module) {}
+};
+
+//*-------------------------------------------------------------------------------------------------------*//
+/// ofxOscMessage
+
+/// Same type tags as ofxOscArgType (the values are the OSC type tag characters)
+
+enum ofxOscArgType {
+    OFXOSC_TYPE_INT32 = 'i',
+    OFXOSC_TYPE_INT64 = 'h',
+    OFXOSC_TYPE_FLOAT = 'f',
+    OFXOSC_TYPE_DOUBLE = 'd',
+    OFXOSC_TYPE_STRING = 's',
+    OFXOSC_TYPE_SYMBOL = 'S',
+    OFXOSC_TYPE_CHAR = 'c',
+    OFXOSC_TYPE_MIDI_MESSAGE = 'm',
+    OFXOSC_TYPE_TRUE = 'T',
+    OFXOSC_TYPE_FALSE = 'F',
+    OFXOSC_TYPE_NONE = 'N',
+    OFXOSC_TYPE_TRIGGER = 'I',
+    OFXOSC_TYPE_TIMETAG = 't',
+    OFXOSC_TYPE_BLOB = 'b',
+    OFXOSC_TYPE_RGBA_COLOR = 'r',
+    OFXOSC_TYPE_BUNDLE = 'B',
+    OFXOSC_TYPE_INDEXOUTOFBOUNDS = 0
+};
+
+/// Owning OSC message with the argument accessors of ofxOscMessage.
+/// Arguments are stored by value in a single vector (no per-argument heap objects). clear() keeps the argument slots
+/// (including the capacity of their strings), so a recycled message doesn't allocate once it has seen its largest content.
+
+class ofxOscMessage {
+public:
+    ofxOscMessage() : remotePort(0), numArgs(0) {}
+
+    void clear() { address.clear(); remoteHost.clear(); remotePort = 0; numArgs = 0; }
+
+    void setAddress(const std::string& address_) { address = address_; }
+    void setAddress(const char* data, std::size_t length) { address.assign(data, length); }
+    const std::string& getAddress() const { return address; }
+
+    void setRemoteEndpoint(const std::string& host, int port) { remoteHost = host; remotePort = port; }
+    const std::string& getRemoteHost() const { return remoteHost; }
+    const std::string& getRemoteIp() const { return remoteHost; }
+    int getRemotePort() const { return remotePort; }
+
+    int getNumArgs() const { return static_cast<int>(numArgs); }
+    ofxOscArgType getArgType(int index) const {
+        return (index >= 0 && index < getNumArgs()) ? args[index].type : OFXOSC_TYPE_INDEXOUTOFBOUNDS;
+    }
+
+    int32_t getArgAsInt(int index) const { return getArgAsInt32(index); }
+    int32_t getArgAsInt32(int index) const { return static_cast<int32_t>(args[index].i); }
+    int64_t getArgAsInt64(int index) const { return args[index].i; }
+    float getArgAsFloat(int index) const { return static_cast<float>(args[index].d); }
+    double getArgAsDouble(int index) const { return args[index].d; }
+    std::string getArgAsString(int index) const { return args[index].s; }
+    std::string getArgAsSymbol(int index) const { return args[index].s; }
+    char getArgAsChar(int index) const { return static_cast<char>(args[index].i); }
+    uint32_t getArgAsMidiMessage(int index) const { return static_cast<uint32_t>(args[index].i); }
+    bool getArgAsBool(int index) const { return args[index].type == OFXOSC_TYPE_TRUE; }
+    bool getArgAsTrigger(int index) const { return args[index].type == OFXOSC_TYPE_TRIGGER; }
+    bool getArgAsImpulse(int index) const { return getArgAsTrigger(index); }
+    uint64_t getArgAsTimetag(int index) const { return static_cast<uint64_t>(args[index].i); }
+    ofBuffer getArgAsBlob(int index) const { return ofBuffer(args[index].s.data(), args[index].s.size()); }
+    uint32_t getArgAsRgbaColor(int index) const { return static_cast<uint32_t>(args[index].i); }
+
+    void addIntArg(int32_t argument) { add(OFXOSC_TYPE_INT32).i = argument; }
+    void addInt32Arg(int32_t argument) { addIntArg(argument); }
+    void addInt64Arg(int64_t argument) { add(OFXOSC_TYPE_INT64).i = argument; }
+    void addFloatArg(float argument) { add(OFXOSC_TYPE_FLOAT).d = argument; }
+    void addDoubleArg(double argument) { add(OFXOSC_TYPE_DOUBLE).d = argument; }
+    void addStringArg(const std::string& argument) { add(OFXOSC_TYPE_STRING).s = argument; }
+    void addStringArg(const char* data, std::size_t length) { add(OFXOSC_TYPE_STRING).s.assign(data, length); }
+    void addSymbolArg(const std::string& argument) { add(OFXOSC_TYPE_SYMBOL).s = argument; }
+    void addSymbolArg(const char* data, std::size_t length) { add(OFXOSC_TYPE_SYMBOL).s.assign(data, length); }
+    void addCharArg(char argument) { add(OFXOSC_TYPE_CHAR).i = argument; }
+    void addMidiMessageArg(uint32_t argument) { add(OFXOSC_TYPE_MIDI_MESSAGE).i = argument; }
+    void addBoolArg(bool argument) { add(argument ? OFXOSC_TYPE_TRUE : OFXOSC_TYPE_FALSE); }
+    void addTriggerArg() { add(OFXOSC_TYPE_TRIGGER); }
+    void addImpulseArg() { addTriggerArg(); }
+    void addNoneArg() { add(OFXOSC_TYPE_NONE); }
+    void addTimetagArg(uint64_t argument) { add(OFXOSC_TYPE_TIMETAG).i = static_cast<int64_t>(argument); }
+    void addBlobArg(const ofBuffer& argument) { add(OFXOSC_TYPE_BLOB).s.assign(argument.getData(), argument.size()); }
+    void addBlobArg(const char* data, std::size_t size) { add(OFXOSC_TYPE_BLOB).s.assign(data, size); }
+    void addRgbaColorArg(uint32_t argument) { add(OFXOSC_TYPE_RGBA_COLOR).i = argument; }
+
+protected:
+    struct Arg {
+        ofxOscArgType type;
+        int64_t i;
+        double d;
+        std::string s; // string, symbol or blob
+    };
+
+    Arg& add(ofxOscArgType type) {
+        // reuse a slot from before the last clear()
+        if (numArgs == args.size()){
+            args.emplace_back();
+        }
+        Arg& arg = args[numArgs++];
+        arg.type = type;
+        arg.i = 0;
+        arg.d = 0;
+        arg.s.clear();
+        return arg;
+    }
+
+    std::string address;
+    std::string remoteHost;
+    int remotePort;
+    std::size_t numArgs;
+    std::vector<Arg> args;
+};
@@ -0,0 +1,228 @@
+#pragma once
+
+#include "ofxEasyOscSocket.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+/// Network impairment simulator (see ofxEasyOscSender::setImpairment() and ofxEasyOscReceiver::setImpairment()).
+///
+/// Drops, duplicates, delays and reorders datagrams and caps the bandwidth, entirely in-process (no tc/netem, no privileges).
+/// The random numbers come from a seeded generator, so a run can be reproduced exactly as long as the datagrams are sent
+/// and received in the same order. On the sender the impairment applies to outgoing datagrams (and to the acknowledgements
+/// of reliable messages), on the receiver to incoming datagrams.
+
+struct ofxEasyOscImpairment {
+    ofxEasyOscImpairment(double loss_ = 0, double latency_ = 0, double jitter_ = 0, uint32_t seed_ = 1)
+        : loss(loss_), duplication(0), reordering(0), latency(latency_), jitter(jitter_), bandwidth(0), queueSize(65536), seed(seed_) {}
+
+    double loss; // probability (0 - 1) that a datagram is dropped
+    double duplication; // probability that a datagram is delivered twice
+    double reordering; // probability that a datagram skips the latency and overtakes the datagrams in flight
+    double latency; // milliseconds
+    double jitter; // additional random delay in milliseconds (uniform 0 - jitter). datagrams can overtake each other.
+    double bandwidth; // bytes per second (0 = unlimited)
+    size_t queueSize; // bytes waiting for the bandwidth cap, excess datagrams are dropped
+    uint32_t seed;
+};
+
+struct ofxEasyOscImpairmentStats {
+    ofxEasyOscImpairmentStats() : numDatagrams(0), numLost(0), numDuplicated(0), numReordered(0), numOverflows(0) {}
+
+    uint64_t numDatagrams; // datagrams which have passed through the simulator
+    uint64_t numLost; // dropped according to 'loss'
+    uint64_t numDuplicated;
+    uint64_t numReordered;
+    uint64_t numOverflows; // dropped because the bandwidth queue was full
+};
+
+//*-------------------------------------------------------------------------------------------------------*//
+/// ofxEasyOscImpairedSocket
+
+/// Drop-in replacement for ofxEasyOscUdpSocket which passes datagrams through the simulator once setImpairment() has been called.
+/// Delayed outgoing datagrams are sent by flush() (also called by every sendTo()), delayed incoming datagrams are returned by receive()
+/// when they are due. wait() wakes up for them as well, but an external event loop (getFileDescriptor()) doesn't know about them,
+/// so call update() regularly while testing.
+
+class ofxEasyOscImpairedSocket : public ofxEasyOscUdpSocket {
+public:
+    ofxEasyOscImpairedSocket() : bImpaired(false), order(0), linkFree(0) {}
+
+    void setImpairment(const ofxEasyOscImpairment& impairment);
+    // deliver everything which is still in flight and pass datagrams through unchanged
+    void removeImpairment();
+    bool isImpaired() const { return bImpaired; }
+    const ofxEasyOscImpairment& getImpairment() const { return settings; }
+    const ofxEasyOscImpairmentStats& getImpairmentStats() const { return stats; }
+
+    bool sendTo(const char* data, size_t size, const ofxEasyOscEndpoint& to);
+    int receive(char* buffer, size_t size, ofxEasyOscEndpoint* from = nullptr);
+    bool wait(int timeoutMs);
+    // send delayed datagrams which are due
+    void flush();
+
+protected:
+    struct Datagram {
+        int64_t due; // nanoseconds
+        uint64_t order; // keeps datagrams with the same due time in order
+        ofxEasyOscEndpoint peer;
+        vector<char> data;
+
+        // for the min heap
+        bool operator<(const Datagram& other) const {
+            return due != other.due ? due > other.due : order > other.order;
+        }
+    };
+
+    static int64_t now(){
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    // uniform random number in [0, 1)
+    double random() { return rng() * (1.0 / 4294967296.0); }
+    // decide the fate of a datagram and queue it
+    void impair(vector<Datagram>& queue, const char* data, size_t size, const ofxEasyOscEndpoint& peer);
+    void push(vector<Datagram>& queue, const char* data, size_t size, const ofxEasyOscEndpoint& peer, int64_t due);
+    bool isDue(const vector<Datagram>& queue, int64_t t) const { return !queue.empty() && queue.front().due <= t; }
+
+    bool bImpaired;
+    ofxEasyOscImpairment settings;
+    ofxEasyOscImpairmentStats stats;
+    std::mt19937 rng;
+    vector<Datagram> outgoing;
+    vector<Datagram> incoming;
+    vector<char> scratch; // for draining the socket
+    uint64_t order;
+    int64_t linkFree; // when the (bandwidth limited) link is idle again
+};
+
+/* definitions */
+
+inline void ofxEasyOscImpairedSocket::setImpairment(const ofxEasyOscImpairment& impairment){
+    settings = impairment;
+    rng.seed(impairment.seed);
+    stats = ofxEasyOscImpairmentStats();
+    linkFree = 0;
+    bImpaired = true;
+}
+
+inline void ofxEasyOscImpairedSocket::removeImpairment(){
+    bImpaired = false;
+    for (auto& datagram : outgoing){
+        ofxEasyOscUdpSocket::sendTo(datagram.data.data(), datagram.data.size(), datagram.peer);
+    }
+    outgoing.clear();
+    // incoming datagrams are returned by receive() before the socket is read again
+}
+
+inline void ofxEasyOscImpairedSocket::push(vector<Datagram>& queue, const char* data, size_t size, const ofxEasyOscEndpoint& peer, int64_t due){
+    Datagram datagram;
+    datagram.due = due;
+    datagram.order = order++;
+    datagram.peer = peer;
+    datagram.data.assign(data, data + size);
+    queue.push_back(std::move(datagram));
+    std::push_heap(queue.begin(), queue.end());
+}
+
+inline void ofxEasyOscImpairedSocket::impair(vector<Datagram>& queue, const char* data, size_t size, const ofxEasyOscEndpoint& peer){
+    ++stats.numDatagrams;
+    // always draw the same numbers per datagram, so changing one setting doesn't shift the others
+    const double lossRandom = random();
+    const double duplicationRandom = random();
+    const double reorderingRandom = random();
+    const double jitterRandom = random();
+    if (lossRandom < settings.loss){
+        ++stats.numLost;
+        return;
+    }
+    const int64_t t = now();
+    int64_t due = t;
+    if (settings.bandwidth > 0){
+        // serialize the datagram on the link
+        const int64_t start = std::max(t, linkFree);
+        if ((start - t) * 1e-9 * settings.bandwidth > settings.queueSize){
+            ++stats.numOverflows;
+            return;
+        }
+        linkFree = start + static_cast<int64_t>(size * 1e9 / settings.bandwidth);
+        due = linkFree;
+    }
+    if (reorderingRandom < settings.reordering){
+        ++stats.numReordered;
+    } else {
+        due += static_cast<int64_t>((settings.latency + jitterRandom * settings.jitter) * 1000000);
+    }
+    push(queue, data, size, peer, due);
+    if (duplicationRandom < settings.duplication){
+        ++stats.numDuplicated;
+        push(queue, data, size, peer, due);
+    }
+}
+
+inline bool ofxEasyOscImpairedSocket::sendTo(const char* data, size_t size, const ofxEasyOscEndpoint& to){
+    if (!bImpaired){
+        return ofxEasyOscUdpSocket::sendTo(data, size, to);
+    }
+    if (!isOpen()){
+        return false;
+    }
+    impair(outgoing, data, size, to);
+    flush();
+    return true;
+}
+
+inline void ofxEasyOscImpairedSocket::flush(){
+    if (outgoing.empty()){
+        return;
+    }
+    const int64_t t = now();
+    while (isDue(outgoing, t)){
+        std::pop_heap(outgoing.begin(), outgoing.end());
+        Datagram& datagram = outgoing.back();
+        ofxEasyOscUdpSocket::sendTo(datagram.data.data(), datagram.data.size(), datagram.peer);
+        outgoing.pop_back();
+    }
+}
+
+inline int ofxEasyOscImpairedSocket::receive(char* buffer, size_t size, ofxEasyOscEndpoint* from){
+    if (bImpaired){
+        // pass everything which is waiting through the simulator
+        if (scratch.empty()){
+            scratch.resize(65536);
+        }
+        ofxEasyOscEndpoint peer;
+        int n;
+        while ((n = ofxEasyOscUdpSocket::receive(scratch.data(), scratch.size(), &peer)) > 0){
+            impair(incoming, scratch.data(), n, peer);
+        }
+    }
+    if (!incoming.empty() && (!bImpaired || isDue(incoming, now()))){
+        std::pop_heap(incoming.begin(), incoming.end());
+        Datagram& datagram = incoming.back();
+        const size_t n = std::min(size, datagram.data.size());
+        std::memcpy(buffer, datagram.data.data(), n);
+        if (from){
+            *from = datagram.peer;
+        }
+        incoming.pop_back();
+        return static_cast<int>(n);
+    }
+    return bImpaired ? -1 : ofxEasyOscUdpSocket::receive(buffer, size, from);
+}
+
+inline bool ofxEasyOscImpairedSocket::wait(int timeoutMs){
+    if (incoming.empty()){
+        return ofxEasyOscUdpSocket::wait(timeoutMs);
+    }
+    // wake up when the next delayed datagram is due
+    const int64_t t = now();
+    if (isDue(incoming, t) || !bImpaired){
+        return true;
+    }
+    const int remaining = static_cast<int>((incoming.front().due - t + 999999) / 1000000);
+    const bool bWaiting = ofxEasyOscUdpSocket::wait(timeoutMs >= 0 ? std::min(timeoutMs, remaining) : remaining);
+    return bWaiting || isDue(incoming, now());
+}
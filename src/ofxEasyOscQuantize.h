@@ -0,0 +1,153 @@
+#pragma once
+
+#include "ofxEasyOscAdapter.h"
+#include "ofxEasyOscCodec.h"
+#include <cstdint>
+#include <cstring>
+
+/// Quantized float arrays (see ofxEasyOscQuantize()).
+///
+/// The floats are sent as a single blob of 8 or 16 bit fixed point values with a per-message scale and offset:
+///
+///   bits (uint8), components (uint8), 2 reserved bytes, scale (float32), offset (float32), count (uint32), 'count' values (big endian)
+///
+/// value = offset + q * scale, with q = 0 ... 2^bits - 1. 'components' is the number of floats per element (e.g. 3 for ofVec3f).
+/// A normalized 0-1 control loses at most 1/510 (8 bit) or 1/131070 (16 bit) of its range and takes a quarter/half of the bytes.
+/// ofxEasyOscReceiver decodes such blobs straight into containers of floats, vectors and matrices.
+/// The loops are branch free and work on plain arrays, so the compiler vectorizes them (like the float byte swap of ofxEasyOscWriter).
+
+#define OFXEASYOSC_QUANTIZED_HEADER_SIZE 16
+
+/// quantization parameters and the floats to send (the data is only referenced, so send it right away)
+struct ofxEasyOscQuantized {
+    ofxEasyOscQuantized(const float* data_, size_t size_, int components_, int bits_, float min_, float max_, bool bAutoRange_)
+        : data(data_), size(size_), components(components_), bits(bits_ > 8 ? 16 : 8), min(min_), max(max_), bAutoRange(bAutoRange_) {}
+
+    const float* data;
+    size_t size; // number of floats
+    int components;
+    int bits; // 8 or 16
+    float min;
+    float max;
+    bool bAutoRange; // use the smallest and largest value of the data
+};
+
+// size of the blob
+inline size_t ofxEasyOscQuantizedSize(size_t count, int bits){
+    return OFXEASYOSC_QUANTIZED_HEADER_SIZE + count * (bits / 8);
+}
+
+// encode into a blob of ofxEasyOscQuantizedSize() bytes
+inline void ofxEasyOscQuantizeFloats(const ofxEasyOscQuantized& q, char* blob){
+    const float* src = q.data;
+    const size_t n = q.size;
+    float min = q.min;
+    float max = q.max;
+    if (q.bAutoRange && n){
+        // 8 independent lanes, so the reduction maps onto vector min/max
+        float lo[8], hi[8];
+        for (int k = 0; k < 8; ++k){
+            lo[k] = hi[k] = src[0];
+        }
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8){
+            for (int k = 0; k < 8; ++k){
+                lo[k] = src[i + k] < lo[k] ? src[i + k] : lo[k];
+                hi[k] = src[i + k] > hi[k] ? src[i + k] : hi[k];
+            }
+        }
+        for (; i < n; ++i){
+            lo[0] = src[i] < lo[0] ? src[i] : lo[0];
+            hi[0] = src[i] > hi[0] ? src[i] : hi[0];
+        }
+        min = lo[0];
+        max = hi[0];
+        for (int k = 1; k < 8; ++k){
+            min = lo[k] < min ? lo[k] : min;
+            max = hi[k] > max ? hi[k] : max;
+        }
+    }
+    const float levels = static_cast<float>((1 << q.bits) - 1);
+    const float range = max - min;
+    // a constant array is sent as all zeros
+    const float scale = range > 0 ? range / levels : 0;
+    const float inverse = range > 0 ? levels / range : 0;
+
+    blob[0] = static_cast<char>(q.bits);
+    blob[1] = static_cast<char>(q.components);
+    blob[2] = blob[3] = 0;
+    uint32_t word;
+    std::memcpy(&word, &scale, 4);
+    ofxEasyOscWrite32(blob + 4, word);
+    std::memcpy(&word, &min, 4);
+    ofxEasyOscWrite32(blob + 8, word);
+    ofxEasyOscWrite32(blob + 12, static_cast<uint32_t>(n));
+
+    unsigned char* dest = reinterpret_cast<unsigned char*>(blob + OFXEASYOSC_QUANTIZED_HEADER_SIZE);
+    if (q.bits == 16){
+        for (size_t i = 0; i < n; ++i){
+            float v = (src[i] - min) * inverse + 0.5f;
+            // clamp (also NaN -> 0)
+            v = v > 0.f ? v : 0.f;
+            v = v < levels ? v : levels;
+            const uint32_t value = static_cast<uint32_t>(v);
+            dest[i * 2] = static_cast<unsigned char>(value >> 8);
+            dest[i * 2 + 1] = static_cast<unsigned char>(value);
+        }
+    } else {
+        for (size_t i = 0; i < n; ++i){
+            float v = (src[i] - min) * inverse + 0.5f;
+            v = v > 0.f ? v : 0.f;
+            v = v < levels ? v : levels;
+            dest[i] = static_cast<unsigned char>(static_cast<uint32_t>(v));
+        }
+    }
+}
+
+// check the header of a quantized blob. returns the number of floats (0 if it isn't a valid quantized blob).
+inline size_t ofxEasyOscQuantizedCount(const char* blob, size_t size){
+    if (size < OFXEASYOSC_QUANTIZED_HEADER_SIZE || (blob[0] != 8 && blob[0] != 16) || blob[2] || blob[3]){
+        return 0;
+    }
+    const size_t count = ofxEasyOscRead32(blob + 12);
+    return ofxEasyOscQuantizedSize(count, blob[0]) <= size ? count : 0;
+}
+
+// decode 'n' floats starting at float 'first' (the blob must have been checked with ofxEasyOscQuantizedCount())
+inline void ofxEasyOscDequantizeFloats(const char* blob, size_t first, size_t n, float* dest){
+    float scale, offset;
+    uint32_t word = ofxEasyOscRead32(blob + 4);
+    std::memcpy(&scale, &word, 4);
+    word = ofxEasyOscRead32(blob + 8);
+    std::memcpy(&offset, &word, 4);
+
+    const unsigned char* src = reinterpret_cast<const unsigned char*>(blob + OFXEASYOSC_QUANTIZED_HEADER_SIZE);
+    if (blob[0] == 16){
+        src += first * 2;
+        for (size_t i = 0; i < n; ++i){
+            const uint32_t value = (uint32_t(src[i * 2]) << 8) | src[i * 2 + 1];
+            dest[i] = offset + static_cast<float>(static_cast<int32_t>(value)) * scale;
+        }
+    } else {
+        src += first;
+        for (size_t i = 0; i < n; ++i){
+            dest[i] = offset + static_cast<float>(static_cast<int32_t>(src[i])) * scale;
+        }
+    }
+}
+
+// element types which can be decoded from a quantized blob
+template <typename T> struct ofxEasyOscIsQuantizable { static const bool value = false; };
+template <> struct ofxEasyOscIsQuantizable<float> { static const bool value = true; };
+template <> struct ofxEasyOscIsQuantizable<ofVec2f> { static const bool value = true; };
+template <> struct ofxEasyOscIsQuantizable<ofVec3f> { static const bool value = true; };
+template <> struct ofxEasyOscIsQuantizable<ofVec4f> { static const bool value = true; };
+template <> struct ofxEasyOscIsQuantizable<ofMatrix3x3> { static const bool value = true; };
+template <> struct ofxEasyOscIsQuantizable<ofMatrix4x4> { static const bool value = true; };
+#ifdef OFXEASYOSC_HAS_GLM
+template <> struct ofxEasyOscIsQuantizable<glm::vec2> { static const bool value = true; };
+template <> struct ofxEasyOscIsQuantizable<glm::vec3> { static const bool value = true; };
+template <> struct ofxEasyOscIsQuantizable<glm::vec4> { static const bool value = true; };
+template <> struct ofxEasyOscIsQuantizable<glm::mat3> { static const bool value = true; };
+template <> struct ofxEasyOscIsQuantizable<glm::mat4> { static const bool value = true; };
+#endif
@@ -0,0 +1,432 @@
+#pragma once
+
+#include "ofxEasyOscAdapter.h"
+#include "ofxEasyOscCodec.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <vector>
+#ifdef __linux__
+#include <time.h>
+#endif
+
+/// Token bucket rate limits for ofxEasyOscSender (see ofxEasyOscSender::setRateLimit()).
+///
+/// Limits can be set per address, per address prefix (every address below the prefix gets its own bucket) and per destination.
+/// A message first passes the bucket of its address and then the bucket of every destination. If a bucket is empty, the policy decides
+/// what happens to the message. Held back messages are sent by ofxEasyOscSender::update() as soon as the bucket has refilled.
+///
+/// The check costs nothing while no limit is set. Otherwise it's a comparison with the previous address (or a hash of the address and
+/// a probe into an open addressing table), and for limited buckets a read of a coarse monotonic clock plus a few floating point operations.
+/// Only addresses with a limit of their own or below a prefix rule get a bucket (created on first use), so a sender with many
+/// dynamic addresses doesn't accumulate buckets. Other addresses only cost the probe.
+
+enum ofxEasyOscRatePolicy {
+    OFXEASYOSC_RATE_DROP, // drop messages which exceed the rate
+    OFXEASYOSC_RATE_KEEP_LATEST, // hold back the latest message per address (older ones are replaced)
+    OFXEASYOSC_RATE_DROP_OLDEST // queue messages and drop the oldest one if the queue is full
+};
+
+struct ofxEasyOscRateLimit {
+    ofxEasyOscRateLimit(double rate_ = 0, double burst_ = 1, ofxEasyOscRatePolicy policy_ = OFXEASYOSC_RATE_KEEP_LATEST, size_t queueSize_ = 16)
+        : rate(rate_), burst(std::max(burst_, 1.0)), policy(policy_), queueSize(std::max<size_t>(queueSize_, 1)) {}
+
+    double rate; // messages per second (0 = unlimited)
+    double burst; // bucket size
+    ofxEasyOscRatePolicy policy;
+    size_t queueSize; // for OFXEASYOSC_RATE_DROP_OLDEST
+};
+
+//*-------------------------------------------------------------------------------------------------------*//
+/// ofxEasyOscTokenBucket
+
+struct ofxEasyOscTokenBucket {
+    ofxEasyOscTokenBucket() : tokens(0), last(0) {}
+
+    // (re)configure the bucket. starts full.
+    void set(const ofxEasyOscRateLimit& limit_){
+        limit = limit_;
+        tokens = limit.burst;
+        last = 0;
+    }
+    bool isLimited() const { return limit.rate > 0; }
+
+    // refill according to the elapsed time
+    void refill(int64_t now){
+        if (last){
+            tokens = std::min(limit.burst, tokens + (now - last) * 1e-9 * limit.rate);
+        }
+        last = now;
+    }
+    bool tryConsume(){
+        if (tokens >= 1){
+            tokens -= 1;
+            return true;
+        }
+        return false;
+    }
+
+    ofxEasyOscRateLimit limit;
+    double tokens;
+    int64_t last; // nanoseconds
+};
+
+//*-------------------------------------------------------------------------------------------------------*//
+/// ofxEasyOscRateLimiter
+
+class ofxEasyOscRateLimiter {
+public:
+    ofxEasyOscRateLimiter() : lastIndex(0), bLastMiss(false), numDropped(0), numDeferred(0), bActive(false) {}
+
+    void setAddressLimit(const string& address, const ofxEasyOscRateLimit& limit);
+    void setPrefixLimit(const string& prefix, const ofxEasyOscRateLimit& limit);
+    void setDestinationLimit(size_t destination, const ofxEasyOscRateLimit& limit);
+    // drop the limits (and held back messages) of destinations beyond 'numDestinations'
+    void resize(size_t numDestinations);
+    // remove all limits (held back messages are dropped)
+    void clear();
+
+    bool isActive() const { return bActive; }
+
+    // pass a message through the buckets. sendTo(data, size, destination, id) is called for every destination which may receive it now.
+    // 'id' is up to the caller (e.g. the interned address) and is passed back with the message, also when it has been held back.
+    template <typename TSendTo>
+    void send(const char* data, size_t size, const char* address, size_t addressLength, uint32_t id, size_t numDestinations,
+              TSendTo&& sendTo);
+    // send held back messages if the buckets allow it
+    template <typename TSendTo>
+    void update(size_t numDestinations, TSendTo&& sendTo);
+
+    uint64_t getNumDropped() const { return numDropped; }
+    uint64_t getNumDeferred() const { return numDeferred; }
+    // number of messages currently held back
+    size_t getNumPending() const;
+
+    // monotonic time in nanoseconds. on Linux we use the coarse clock (a few milliseconds resolution, but several times faster),
+    // which is good enough for rate limits since the buckets integrate over time anyway.
+    static int64_t now(){
+#if defined(__linux__) && defined(CLOCK_MONOTONIC_COARSE)
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+        return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+protected:
+    struct Pending {
+        vector<char> data;
+        string address; // the original address (the data might be a delta message or a keyframe)
+        uint32_t id;
+    };
+
+    struct Bucket : ofxEasyOscTokenBucket {
+        deque<Pending> pending;
+    };
+
+    struct AddressBucket : Bucket {
+        AddressBucket() : hash(0), bExplicit(false) {}
+        string address;
+        uint32_t hash;
+        bool bExplicit; // set with setAddressLimit(), prefix rules don't apply
+    };
+
+    // the bucket of an address, created on first use if a prefix rule matches it (nullptr if no limit applies)
+    AddressBucket* lookup(const char* address, size_t length);
+    // an existing bucket (nullptr if none)
+    AddressBucket* find(const char* address, size_t length, uint32_t hash);
+    AddressBucket& insert(const char* address, size_t length, uint32_t hash);
+    // the longest prefix rule which matches the address (nullptr if none)
+    const pair<string, ofxEasyOscRateLimit>* findPrefix(const char* address, size_t length) const;
+    // rebuild the index after the table has grown
+    void rehash();
+    // hold back a message according to the bucket's policy
+    void defer(Bucket& bucket, const char* data, size_t size, const char* address, size_t addressLength, uint32_t id);
+    // pass a message through the destination buckets
+    // 't' is the current time or 0 if it hasn't been read yet
+    template <typename TSendTo>
+    void sendToDestinations(const char* data, size_t size, const char* address, size_t addressLength, uint32_t id,
+                            size_t numDestinations, int64_t t, TSendTo&& sendTo);
+
+    vector<AddressBucket> addresses;
+    vector<int32_t> slots; // open addressing index into 'addresses' (-1 = empty)
+    size_t lastIndex; // the address of the previous message (usually the same)
+    string lastMiss; // the previous address without a bucket
+    bool bLastMiss;
+    vector<pair<string, ofxEasyOscRateLimit>> prefixes;
+    vector<Bucket> destinations;
+    uint64_t numDropped;
+    uint64_t numDeferred;
+    bool bActive;
+};
+
+/* definitions */
+
+inline void ofxEasyOscRateLimiter::setAddressLimit(const string& address, const ofxEasyOscRateLimit& limit){
+    const uint32_t hash = ofxEasyOscHash(address.data(), address.size());
+    AddressBucket* bucket = find(address.data(), address.size(), hash);
+    if (!bucket){
+        bucket = &insert(address.data(), address.size(), hash);
+    }
+    bucket->set(limit);
+    bucket->bExplicit = true;
+    bLastMiss = false;
+    bActive = true;
+}
+
+inline void ofxEasyOscRateLimiter::setPrefixLimit(const string& prefix, const ofxEasyOscRateLimit& limit){
+    bool bFound = false;
+    for (auto& rule : prefixes){
+        if (rule.first == prefix){
+            rule.second = limit;
+            bFound = true;
+            break;
+        }
+    }
+    if (!bFound){
+        prefixes.push_back(make_pair(prefix, limit));
+    }
+    // existing buckets below the prefix get the rule if it is now their longest match (unless they have a limit of their own)
+    for (auto& bucket : addresses){
+        if (!bucket.bExplicit && bucket.address.compare(0, prefix.size(), prefix) == 0){
+            const pair<string, ofxEasyOscRateLimit>* rule = findPrefix(bucket.address.data(), bucket.address.size());
+            if (rule && rule->first.size() == prefix.size()){
+                bucket.set(limit);
+            }
+        }
+    }
+    bLastMiss = false;
+    bActive = true;
+}
+
+inline const pair<string, ofxEasyOscRateLimit>* ofxEasyOscRateLimiter::findPrefix(const char* address, size_t length) const {
+    const pair<string, ofxEasyOscRateLimit>* best = nullptr;
+    for (auto& rule : prefixes){
+        if (rule.first.size() <= length && (!best || rule.first.size() >= best->first.size())
+                && std::memcmp(rule.first.data(), address, rule.first.size()) == 0){
+            best = &rule;
+        }
+    }
+    return best;
+}
+
+inline void ofxEasyOscRateLimiter::setDestinationLimit(size_t destination, const ofxEasyOscRateLimit& limit){
+    if (destination >= destinations.size()){
+        destinations.resize(destination + 1);
+    }
+    destinations[destination].set(limit);
+    bActive = true;
+}
+
+inline void ofxEasyOscRateLimiter::resize(size_t numDestinations){
+    if (numDestinations < destinations.size()){
+        destinations.resize(numDestinations);
+    }
+    bActive = !addresses.empty() || !prefixes.empty() || !destinations.empty();
+}
+
+inline void ofxEasyOscRateLimiter::clear(){
+    addresses.clear();
+    lastIndex = 0;
+    bLastMiss = false;
+    slots.clear();
+    prefixes.clear();
+    destinations.clear();
+    bActive = false;
+}
+
+inline size_t ofxEasyOscRateLimiter::getNumPending() const {
+    size_t n = 0;
+    for (auto& bucket : addresses){
+        n += bucket.pending.size();
+    }
+    for (auto& bucket : destinations){
+        n += bucket.pending.size();
+    }
+    return n;
+}
+
+inline ofxEasyOscRateLimiter::AddressBucket* ofxEasyOscRateLimiter::lookup(const char* address, size_t length){
+    if (lastIndex < addresses.size()){
+        AddressBucket& bucket = addresses[lastIndex];
+        if (bucket.address.size() == length && std::memcmp(bucket.address.data(), address, length) == 0){
+            return &bucket;
+        }
+    }
+    if (bLastMiss && lastMiss.size() == length && std::memcmp(lastMiss.data(), address, length) == 0){
+        return nullptr;
+    }
+    const uint32_t hash = ofxEasyOscHash(address, length);
+    if (AddressBucket* bucket = find(address, length, hash)){
+        return bucket;
+    }
+    // new address: only the longest matching prefix rule (if any) gives it a bucket
+    if (const pair<string, ofxEasyOscRateLimit>* rule = findPrefix(address, length)){
+        AddressBucket& bucket = insert(address, length, hash);
+        bucket.set(rule->second);
+        return &bucket;
+    }
+    lastMiss.assign(address, length);
+    bLastMiss = true;
+    return nullptr;
+}
+
+inline ofxEasyOscRateLimiter::AddressBucket* ofxEasyOscRateLimiter::find(const char* address, size_t length, uint32_t hash){
+    if (!slots.empty()){
+        const size_t mask = slots.size() - 1;
+        for (size_t i = hash & mask; slots[i] >= 0; i = (i + 1) & mask){
+            AddressBucket& bucket = addresses[slots[i]];
+            if (bucket.hash == hash && bucket.address.size() == length && std::memcmp(bucket.address.data(), address, length) == 0){
+                lastIndex = slots[i];
+                return &bucket;
+            }
+        }
+    }
+    return nullptr;
+}
+
+inline ofxEasyOscRateLimiter::AddressBucket& ofxEasyOscRateLimiter::insert(const char* address, size_t length, uint32_t hash){
+    AddressBucket bucket;
+    bucket.address.assign(address, length);
+    bucket.hash = hash;
+    addresses.push_back(std::move(bucket));
+    // keep the load factor below 0.5
+    if (addresses.size() * 2 > slots.size()){
+        rehash();
+    } else {
+        const size_t mask = slots.size() - 1;
+        size_t i = hash & mask;
+        while (slots[i] >= 0){
+            i = (i + 1) & mask;
+        }
+        slots[i] = static_cast<int32_t>(addresses.size() - 1);
+    }
+    lastIndex = addresses.size() - 1;
+    return addresses.back();
+}
+
+inline void ofxEasyOscRateLimiter::rehash(){
+    size_t size = 16;
+    while (size < addresses.size() * 2){
+        size *= 2;
+    }
+    slots.assign(size, -1);
+    const size_t mask = size - 1;
+    for (size_t k = 0; k < addresses.size(); ++k){
+        size_t i = addresses[k].hash & mask;
+        while (slots[i] >= 0){
+            i = (i + 1) & mask;
+        }
+        slots[i] = static_cast<int32_t>(k);
+    }
+}
+
+inline void ofxEasyOscRateLimiter::defer(Bucket& bucket, const char* data, size_t size, const char* address, size_t addressLength,
+                                         uint32_t id){
+    switch (bucket.limit.policy){
+    case OFXEASYOSC_RATE_KEEP_LATEST:
+        // replace a held back message with the same address
+        for (auto& pending : bucket.pending){
+            if (pending.address.size() == addressLength && std::memcmp(pending.address.data(), address, addressLength) == 0){
+                pending.data.assign(data, data + size);
+                ++numDropped;
+                return;
+            }
+        }
+        break;
+    case OFXEASYOSC_RATE_DROP_OLDEST:
+        if (bucket.pending.size() >= bucket.limit.queueSize){
+            bucket.pending.pop_front();
+            ++numDropped;
+        }
+        break;
+    default:
+        ++numDropped;
+        return;
+    }
+    Pending pending;
+    pending.data.assign(data, data + size);
+    pending.address.assign(address, addressLength);
+    pending.id = id;
+    bucket.pending.push_back(std::move(pending));
+    ++numDeferred;
+}
+
+template <typename TSendTo>
+inline void ofxEasyOscRateLimiter::sendToDestinations(const char* data, size_t size, const char* address, size_t addressLength,
+                                                      uint32_t id, size_t numDestinations, int64_t t, TSendTo&& sendTo){
+    for (size_t i = 0; i < numDestinations; ++i){
+        if (i < destinations.size() && destinations[i].isLimited()){
+            Bucket& bucket = destinations[i];
+            if (!t){
+                t = now();
+            }
+            bucket.refill(t);
+            // held back messages go first
+            while (!bucket.pending.empty() && bucket.tryConsume()){
+                sendTo(bucket.pending.front().data.data(), bucket.pending.front().data.size(), i, bucket.pending.front().id);
+                bucket.pending.pop_front();
+            }
+            if (bucket.pending.empty() && bucket.tryConsume()){
+                sendTo(data, size, i, id);
+            } else {
+                defer(bucket, data, size, address, addressLength, id);
+            }
+        } else {
+            sendTo(data, size, i, id);
+        }
+    }
+}
+
+template <typename TSendTo>
+inline void ofxEasyOscRateLimiter::send(const char* data, size_t size, const char* address, size_t addressLength, uint32_t id,
+                                        size_t numDestinations, TSendTo&& sendTo){
+    int64_t t = 0;
+    AddressBucket* bucket = lookup(address, addressLength);
+    if (bucket && bucket->isLimited()){
+        t = now();
+        bucket->refill(t);
+        // keep the order: held back messages go first
+        while (!bucket->pending.empty() && bucket->tryConsume()){
+            Pending pending = std::move(bucket->pending.front());
+            bucket->pending.pop_front();
+            sendToDestinations(pending.data.data(), pending.data.size(), pending.address.data(), pending.address.size(),
+                               pending.id, numDestinations, t, sendTo);
+        }
+        if (!bucket->pending.empty() || !bucket->tryConsume()){
+            defer(*bucket, data, size, address, addressLength, id);
+            return;
+        }
+    }
+    sendToDestinations(data, size, address, addressLength, id, numDestinations, t, sendTo);
+}
+
+template <typename TSendTo>
+inline void ofxEasyOscRateLimiter::update(size_t numDestinations, TSendTo&& sendTo){
+    const int64_t t = now();
+    for (auto& bucket : addresses){
+        if (!bucket.pending.empty()){
+            bucket.refill(t);
+            while (!bucket.pending.empty() && bucket.tryConsume()){
+                Pending pending = std::move(bucket.pending.front());
+                bucket.pending.pop_front();
+                sendToDestinations(pending.data.data(), pending.data.size(), pending.address.data(), pending.address.size(),
+                                   pending.id, numDestinations, t, sendTo);
+            }
+        }
+    }
+    for (size_t i = 0; i < destinations.size() && i < numDestinations; ++i){
+        Bucket& bucket = destinations[i];
+        if (!bucket.pending.empty()){
+            bucket.refill(t);
+            while (!bucket.pending.empty() && bucket.tryConsume()){
+                sendTo(bucket.pending.front().data.data(), bucket.pending.front().data.size(), i, bucket.pending.front().id);
+                bucket.pending.pop_front();
+            }
+        }
+    }
+}
@@ -0,0 +1,443 @@
+#pragma once
+
+#include "ofxEasyOscAdapter.h"
+#include "ofxEasyOscCodec.h"
+#include "ofxEasyOscSocket.h"
+#include "ofxEasyOscRateLimiter.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+/// Selective reliable delivery over UDP (see ofxEasyOscSender::setReliable()).
+///
+/// Messages of reliable addresses are wrapped in a bundle whose first element is a "/#r" message with three int32 arguments:
+/// the stream id (random per sender), the sequence number (per destination) and the oldest sequence number the sender still keeps.
+/// The receiver answers every reliable datagram with an "/#a" message: the stream id, the next sequence number it is waiting for
+/// (everything below has arrived) and a NACK mask (bit n set = next+n is missing). The sender keeps unacknowledged messages in a bounded
+/// retransmit buffer and sends them again when they are NACKed or when the retransmit timeout expires.
+///
+/// Reliable messages are dispatched once (duplicates are suppressed), but as soon as they arrive, so a lost message never delays the
+/// following ones. Messages the sender has given up on (too many retries or evicted from a full buffer) are skipped by the receiver.
+/// Plain OSC peers simply see an extra message and never answer, so the sender keeps retrying until it gives up.
+
+// address of the header message
+#define OFXEASYOSC_RELIABLE_ADDRESS "/#r"
+// address of the acknowledgement
+#define OFXEASYOSC_ACK_ADDRESS "/#a"
+
+struct ofxEasyOscReliableStats {
+    ofxEasyOscReliableStats() : numSent(0), numRetransmitted(0), numAcked(0), numFailed(0),
+        numReceived(0), numDuplicates(0), numNacks(0), numSkipped(0) {}
+
+    // sender
+    uint64_t numSent; // reliable messages (without retransmissions)
+    uint64_t numRetransmitted;
+    uint64_t numAcked;
+    uint64_t numFailed; // given up after too many retries or evicted from a full buffer
+    // receiver
+    uint64_t numReceived; // reliable datagrams (including duplicates)
+    uint64_t numDuplicates; // always discarded
+    uint64_t numNacks; // acknowledgements which requested a retransmission
+    uint64_t numSkipped; // messages the sender has given up on
+};
+
+//*-------------------------------------------------------------------------------------------------------*//
+/// ofxEasyOscReliableSender
+
+/// Retransmit buffer of ofxEasyOscSender. sendTo(data, size, destination) sends a datagram to a destination.
+
+class ofxEasyOscReliableSender {
+public:
+    // the receiver can only keep track of this many messages, so this is also the maximum buffer size
+    static const size_t maxWindow = 64;
+    // bundle header + header message + size of the wrapped element
+    static const size_t overhead = 16 + 4 + 24 + 4;
+
+    ofxEasyOscReliableSender() : stream(0), timeout(50000000), maxRetries(10), bufferSize(32) {}
+
+    // exact addresses and address prefixes
+    void addAddress(const string& address);
+    void addPrefix(const string& prefix);
+    void clear();
+
+    bool isActive() const { return !addresses.empty() || !prefixes.empty(); }
+    bool isReliable(const char* address, size_t length) const;
+
+    // retransmit timeout (doubled with every retry, up to 4 times) and number of retries before giving up
+    void setTimeout(double ms) { timeout = static_cast<int64_t>(ms * 1000000); }
+    double getTimeout() const { return timeout * 1e-6; }
+    void setMaxRetries(int retries) { maxRetries = std::max(retries, 0); }
+    int getMaxRetries() const { return maxRetries; }
+    // unacknowledged messages per destination. if the buffer is full, the oldest message is given up.
+    void setBufferSize(size_t numMessages) { bufferSize = numMessages < 1 ? 1 : numMessages > maxWindow ? size_t(maxWindow) : numMessages; }
+    size_t getBufferSize() const { return bufferSize; }
+
+    // (re)set the number of destinations
+    void resize(size_t numDestinations) { channels.resize(numDestinations); }
+    // forget all destinations and their unacknowledged messages. the sequence numbers start again with a new stream id.
+    void reset();
+
+    // send a new reliable message
+    template <typename TSendTo>
+    void send(const char* data, size_t size, size_t destination, TSendTo&& sendTo);
+    // handle an "/#a" message from a destination. returns false if it isn't one.
+    template <typename TSendTo>
+    bool receive(const ofxEasyOscMessageView& msg, size_t destination, TSendTo&& sendTo);
+    // retransmit timed out messages
+    template <typename TSendTo>
+    void update(TSendTo&& sendTo);
+
+    uint32_t getStreamId() const { return stream; }
+    // number of unacknowledged messages
+    size_t getNumPending() const;
+    const ofxEasyOscReliableStats& getStats() const { return stats; }
+
+protected:
+    struct Entry {
+        uint32_t sequence;
+        vector<char> datagram; // including the header
+        int64_t lastSent;
+        int retries;
+    };
+
+    struct Channel {
+        Channel() : next(0) {}
+        uint32_t next;
+        deque<Entry> pending; // ordered by sequence number
+    };
+
+    // oldest sequence number still kept for a channel
+    static uint32_t base(const Channel& channel) { return channel.pending.empty() ? channel.next : channel.pending.front().sequence; }
+    void giveUp(Channel& channel);
+    template <typename TSendTo>
+    void retransmit(Channel& channel, Entry& entry, size_t destination, int64_t now, TSendTo&& sendTo);
+
+    vector<string> addresses;
+    vector<string> prefixes;
+    vector<Channel> channels;
+    uint32_t stream;
+    int64_t timeout; // nanoseconds
+    int maxRetries;
+    size_t bufferSize;
+    ofxEasyOscReliableStats stats;
+};
+
+//*-------------------------------------------------------------------------------------------------------*//
+/// ofxEasyOscReliableTracker
+
+/// Duplicate suppression and acknowledgements of ofxEasyOscReceiver, per source (remote endpoint).
+
+class ofxEasyOscReliableTracker {
+public:
+    ofxEasyOscReliableTracker() : lastIndex(0) {}
+
+    // parse a "/#r" message. returns false if it isn't one.
+    static bool read(const ofxEasyOscMessageView& msg, uint32_t& stream, uint32_t& sequence, uint32_t& base);
+
+    // returns false if the datagram is a duplicate. reply(data, size) sends the acknowledgement back to the sender.
+    template <typename TReply>
+    bool track(const ofxEasyOscEndpoint& from, uint32_t stream, uint32_t sequence, uint32_t base, TReply&& reply);
+
+    const ofxEasyOscReliableStats& getStats() const { return stats; }
+
+    void clear();
+
+protected:
+    struct Source {
+        ofxEasyOscEndpoint from;
+        uint32_t stream;
+        uint32_t next; // everything below has arrived
+        uint64_t window; // bit n = next + n has arrived
+    };
+
+    Source& lookup(const ofxEasyOscEndpoint& from, uint32_t stream, uint32_t base);
+    // move the window forward
+    static void advance(Source& source, uint32_t n);
+
+    vector<Source> sources;
+    size_t lastIndex;
+    ofxEasyOscReliableStats stats;
+};
+
+/* definitions */
+
+inline void ofxEasyOscReliableSender::addAddress(const string& address){
+    if (std::find(addresses.begin(), addresses.end(), address) == addresses.end()){
+        addresses.push_back(address);
+    }
+    if (!stream){
+        std::random_device random;
+        stream = random() | 1; // never 0
+    }
+}
+
+inline void ofxEasyOscReliableSender::addPrefix(const string& prefix){
+    if (std::find(prefixes.begin(), prefixes.end(), prefix) == prefixes.end()){
+        prefixes.push_back(prefix);
+    }
+    if (!stream){
+        std::random_device random;
+        stream = random() | 1;
+    }
+}
+
+inline void ofxEasyOscReliableSender::clear(){
+    addresses.clear();
+    prefixes.clear();
+    for (auto& channel : channels){
+        channel.pending.clear();
+    }
+}
+
+inline void ofxEasyOscReliableSender::reset(){
+    channels.clear();
+    if (stream){
+        std::random_device random;
+        stream = random() | 1;
+    }
+}
+
+inline bool ofxEasyOscReliableSender::isReliable(const char* address, size_t length) const {
+    // usually there are only a handful of critical addresses
+    for (auto& a : addresses){
+        if (a.size() == length && std::memcmp(a.data(), address, length) == 0){
+            return true;
+        }
+    }
+    for (auto& p : prefixes){
+        if (p.size() <= length && std::memcmp(p.data(), address, p.size()) == 0){
+            return true;
+        }
+    }
+    return false;
+}
+
+inline size_t ofxEasyOscReliableSender::getNumPending() const {
+    size_t n = 0;
+    for (auto& channel : channels){
+        n += channel.pending.size();
+    }
+    return n;
+}
+
+inline void ofxEasyOscReliableSender::giveUp(Channel& channel){
+    channel.pending.pop_front();
+    ++stats.numFailed;
+}
+
+template <typename TSendTo>
+inline void ofxEasyOscReliableSender::send(const char* data, size_t size, size_t destination, TSendTo&& sendTo){
+    Channel& channel = channels[destination];
+    if (channel.pending.size() >= bufferSize){
+        giveUp(channel);
+    }
+    const uint32_t oldest = channel.pending.empty() ? channel.next : channel.pending.front().sequence;
+    Entry entry;
+    entry.sequence = channel.next++;
+    entry.retries = 0;
+    entry.lastSent = ofxEasyOscRateLimiter::now();
+    // "#bundle", time tag 1 (immediately), size of the header message, "/#r" ",iii" stream sequence base, size of the message
+    entry.datagram.resize(overhead + size);
+    char* p = entry.datagram.data();
+    std::memcpy(p, "#bundle", 8);
+    ofxEasyOscWrite64(p + 8, 1);
+    ofxEasyOscWrite32(p + 16, 24);
+    std::memcpy(p + 20, OFXEASYOSC_RELIABLE_ADDRESS, 4);
+    std::memcpy(p + 24, ",iii\0\0\0", 8);
+    ofxEasyOscWrite32(p + 32, stream);
+    ofxEasyOscWrite32(p + 36, entry.sequence);
+    ofxEasyOscWrite32(p + 40, oldest);
+    ofxEasyOscWrite32(p + 44, static_cast<uint32_t>(size));
+    std::memcpy(p + overhead, data, size);
+
+    sendTo(entry.datagram.data(), entry.datagram.size(), destination);
+    ++stats.numSent;
+    channel.pending.push_back(std::move(entry));
+}
+
+template <typename TSendTo>
+inline void ofxEasyOscReliableSender::retransmit(Channel& channel, Entry& entry, size_t destination, int64_t now, TSendTo&& sendTo){
+    // the base may have moved in the meantime
+    ofxEasyOscWrite32(entry.datagram.data() + 40, base(channel));
+    sendTo(entry.datagram.data(), entry.datagram.size(), destination);
+    entry.lastSent = now;
+    ++entry.retries;
+    ++stats.numRetransmitted;
+}
+
+template <typename TSendTo>
+inline bool ofxEasyOscReliableSender::receive(const ofxEasyOscMessageView& msg, size_t destination, TSendTo&& sendTo){
+    if (!(msg.getAddressLength() == 3 && std::memcmp(msg.getAddressData(), OFXEASYOSC_ACK_ADDRESS, 3) == 0
+            && msg.getTypeTagsLength() == 3 && std::memcmp(msg.getTypeTags(), "iii", 3) == 0)){
+        return false;
+    }
+    if (static_cast<uint32_t>(msg.getArgAsInt32(0)) != stream || destination >= channels.size()){
+        return true; // an old stream or an unknown peer
+    }
+    Channel& channel = channels[destination];
+    const uint32_t next = static_cast<uint32_t>(msg.getArgAsInt32(1));
+    const uint32_t nack = static_cast<uint32_t>(msg.getArgAsInt32(2));
+    // free acknowledged messages
+    while (!channel.pending.empty() && static_cast<int32_t>(next - channel.pending.front().sequence) > 0){
+        channel.pending.pop_front();
+        ++stats.numAcked;
+    }
+    if (nack){
+        const int64_t now = ofxEasyOscRateLimiter::now();
+        for (auto& entry : channel.pending){
+            const uint32_t offset = entry.sequence - next;
+            if (offset >= 32){
+                break;
+            }
+            // every later arrival NACKs the gap again, so don't repeat a retransmission which is still under way
+            if ((nack & (uint32_t(1) << offset)) && (!entry.retries || now - entry.lastSent >= timeout / 4)){
+                retransmit(channel, entry, destination, now, sendTo);
+            }
+        }
+    }
+    return true;
+}
+
+template <typename TSendTo>
+inline void ofxEasyOscReliableSender::update(TSendTo&& sendTo){
+    int64_t now = 0;
+    for (size_t i = 0; i < channels.size(); ++i){
+        Channel& channel = channels[i];
+        if (channel.pending.empty()){
+            continue;
+        }
+        if (!now){
+            now = ofxEasyOscRateLimiter::now();
+        }
+        // give up on the oldest messages first, so the base is up to date for the retransmissions
+        while (!channel.pending.empty() && channel.pending.front().retries >= maxRetries
+               && now - channel.pending.front().lastSent >= (timeout << std::min(channel.pending.front().retries, 4))){
+            giveUp(channel);
+        }
+        for (auto& entry : channel.pending){
+            if (entry.retries < maxRetries && now - entry.lastSent >= (timeout << std::min(entry.retries, 4))){
+                retransmit(channel, entry, i, now, sendTo);
+            }
+        }
+    }
+}
+
+inline bool ofxEasyOscReliableTracker::read(const ofxEasyOscMessageView& msg, uint32_t& stream, uint32_t& sequence, uint32_t& base){
+    if (msg.getAddressLength() == 3 && std::memcmp(msg.getAddressData(), OFXEASYOSC_RELIABLE_ADDRESS, 3) == 0
+            && msg.getTypeTagsLength() == 3 && std::memcmp(msg.getTypeTags(), "iii", 3) == 0){
+        stream = static_cast<uint32_t>(msg.getArgAsInt32(0));
+        sequence = static_cast<uint32_t>(msg.getArgAsInt32(1));
+        base = static_cast<uint32_t>(msg.getArgAsInt32(2));
+        return true;
+    }
+    return false;
+}
+
+inline ofxEasyOscReliableTracker::Source& ofxEasyOscReliableTracker::lookup(const ofxEasyOscEndpoint& from, uint32_t stream, uint32_t base){
+    Source* source = nullptr;
+    if (lastIndex < sources.size() && sources[lastIndex].from == from){
+        source = &sources[lastIndex];
+    } else {
+        for (size_t i = 0; i < sources.size(); ++i){
+            if (sources[i].from == from){
+                lastIndex = i;
+                source = &sources[i];
+                break;
+            }
+        }
+        if (!source){
+            sources.emplace_back();
+            lastIndex = sources.size() - 1;
+            source = &sources.back();
+            source->from = from;
+            source->stream = stream + 1; // force a reset below
+        }
+    }
+    // a new stream (the sender has been restarted) starts at the sender's base
+    if (source->stream != stream){
+        source->stream = stream;
+        source->next = base;
+        source->window = 0;
+    }
+    return *source;
+}
+
+inline void ofxEasyOscReliableTracker::advance(Source& source, uint32_t n){
+    source.window = n < 64 ? source.window >> n : 0;
+    source.next += n;
+    // skip everything which has arrived in the meantime
+    while (source.window & 1){
+        source.window >>= 1;
+        ++source.next;
+    }
+}
+
+template <typename TReply>
+inline bool ofxEasyOscReliableTracker::track(const ofxEasyOscEndpoint& from, uint32_t stream, uint32_t sequence, uint32_t base, TReply&& reply){
+    Source& source = lookup(from, stream, base);
+    ++stats.numReceived;
+
+    // the sender has given up on everything below its base
+    const int32_t skipped = static_cast<int32_t>(base - source.next);
+    if (skipped > 0){
+        for (int32_t i = 0; i < std::min(skipped, 64); ++i){
+            if (!(source.window & (uint64_t(1) << i))){
+                ++stats.numSkipped;
+            }
+        }
+        if (skipped > 64){
+            stats.numSkipped += skipped - 64;
+        }
+        advance(source, skipped);
+    }
+
+    bool bNew = false;
+    const int32_t offset = static_cast<int32_t>(sequence - source.next);
+    if (offset >= 0){
+        if (offset >= 64){
+            // can't happen with a well-behaved sender (the buffer is smaller than the window)
+            stats.numSkipped += offset - 63;
+            advance(source, offset - 63);
+        }
+        const uint64_t bit = uint64_t(1) << (sequence - source.next);
+        if (!(source.window & bit)){
+            source.window |= bit;
+            advance(source, 0);
+            bNew = true;
+        }
+    }
+    if (!bNew){
+        ++stats.numDuplicates;
+    }
+
+    // always acknowledge (also duplicates, the previous acknowledgement might have been lost)
+    uint32_t nack = 0;
+    if (source.window){
+        // everything between 'next' and the newest message is missing unless its bit is set
+        const uint32_t missing = static_cast<uint32_t>(~source.window);
+        int highest = 63;
+        while (!((source.window >> highest) & 1)){
+            --highest;
+        }
+        nack = highest >= 32 ? missing : missing & ((uint32_t(1) << highest) - 1);
+        ++stats.numNacks;
+    }
+    char ack[24];
+    std::memcpy(ack, OFXEASYOSC_ACK_ADDRESS, 4);
+    std::memcpy(ack + 4, ",iii\0\0\0", 8);
+    ofxEasyOscWrite32(ack + 12, source.stream);
+    ofxEasyOscWrite32(ack + 16, source.next);
+    ofxEasyOscWrite32(ack + 20, nack);
+    reply(ack, 24);
+    return bNew;
+}
+
+inline void ofxEasyOscReliableTracker::clear(){
+    sources.clear();
+    lastIndex = 0;
+    stats = ofxEasyOscReliableStats();
+}
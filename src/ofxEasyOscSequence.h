@@ -0,0 +1,260 @@
+#pragma once
+
+#include "ofxEasyOscAdapter.h"
+#include "ofxEasyOscCodec.h"
+#include "ofxEasyOscSocket.h"
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/// Sequence numbers for UDP streams (see ofxEasyOscSender::setSequenceNumbers()).
+///
+/// The sender wraps every datagram in a bundle whose first element is a "/#s" message with two int32 arguments:
+/// the stream id (random per sender, so a restarted sender starts a new stream) and the sequence number (per destination).
+/// Plain OSC peers simply see an extra message. ofxEasyOscReceiver recognizes the header, never dispatches it and tracks
+/// every source with a 64 message window, so it can tell lost, duplicated and reordered datagrams apart.
+
+// address of the header message
+#define OFXEASYOSC_SEQUENCE_ADDRESS "/#s"
+
+/// what the receiver does with messages which arrive after a newer datagram of the same stream
+enum ofxEasyOscLatePolicy {
+    OFXEASYOSC_LATE_DISPATCH, // dispatch them anyway (they are only counted)
+    OFXEASYOSC_LATE_DISCARD // discard them, so stale values don't overwrite newer ones
+};
+
+/// result of ofxEasyOscSequenceTracker::track()
+enum ofxEasyOscSequenceResult {
+    OFXEASYOSC_SEQUENCE_IN_ORDER,
+    OFXEASYOSC_SEQUENCE_LATE, // older than the newest datagram seen so far
+    OFXEASYOSC_SEQUENCE_DUPLICATE
+};
+
+struct ofxEasyOscSequenceStats {
+    ofxEasyOscSequenceStats() : numReceived(0), numLost(0), numDuplicates(0), numReordered(0), numDiscarded(0) {}
+
+    // the first two are not available per address
+    uint64_t numReceived; // datagrams with a sequence header
+    uint64_t numLost; // gaps in the sequence which haven't been filled by late datagrams
+    uint64_t numDuplicates; // always discarded
+    uint64_t numReordered; // arrived late
+    uint64_t numDiscarded; // late datagrams/messages which have been discarded (see ofxEasyOscLatePolicy)
+};
+
+/// Per-address counters of ofxEasyOscReceiver, readable from any thread while update() runs.
+/// A lost datagram never arrives, so losses are only known per source (see ofxEasyOscSequenceTracker), not per address.
+struct ofxEasyOscSequenceCounters {
+    ofxEasyOscSequenceCounters() {}
+    ofxEasyOscSequenceCounters(const ofxEasyOscSequenceCounters& other) { *this = other; }
+    ofxEasyOscSequenceCounters& operator=(const ofxEasyOscSequenceCounters& other){
+        numDuplicates.store(other.numDuplicates.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        numReordered.store(other.numReordered.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        numDiscarded.store(other.numDiscarded.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        return *this;
+    }
+
+    ofxEasyOscSequenceStats load() const {
+        ofxEasyOscSequenceStats stats;
+        stats.numDuplicates = numDuplicates.load(std::memory_order_relaxed);
+        stats.numReordered = numReordered.load(std::memory_order_relaxed);
+        stats.numDiscarded = numDiscarded.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    std::atomic<uint64_t> numDuplicates { 0 };
+    std::atomic<uint64_t> numReordered { 0 };
+    std::atomic<uint64_t> numDiscarded { 0 };
+};
+
+//*-------------------------------------------------------------------------------------------------------*//
+/// ofxEasyOscSequenceHeader
+
+/// Wraps outgoing datagrams into a bundle with a sequence header. The envelope buffer is reused.
+
+class ofxEasyOscSequenceHeader {
+public:
+    // bundle header + header message + size of the wrapped element
+    static const size_t overhead = 16 + 4 + 16 + 4;
+
+    // returns the envelope, valid until the next call
+    const vector<char>& wrap(const char* data, size_t size, uint32_t stream, uint32_t sequence);
+
+    // parse a "/#s" message. returns false if it isn't one.
+    static bool read(const ofxEasyOscMessageView& msg, uint32_t& stream, uint32_t& sequence);
+
+protected:
+    vector<char> envelope;
+};
+
+//*-------------------------------------------------------------------------------------------------------*//
+/// ofxEasyOscSequenceTracker
+
+/// Keeps the sequence state of every source (remote endpoint) of a receiver.
+/// The totals are atomic counters, so they can be read from any thread (e.g. a monitoring thread) while update() runs.
+/// Per source statistics must be read from the thread which calls update().
+
+class ofxEasyOscSequenceTracker {
+public:
+    ofxEasyOscSequenceTracker() : lastIndex(0) {}
+
+    ofxEasyOscSequenceResult track(const ofxEasyOscEndpoint& from, uint32_t stream, uint32_t sequence);
+    // count a late datagram which has been discarded
+    void discard(const ofxEasyOscEndpoint& from);
+
+    ofxEasyOscSequenceStats getStats() const;
+    ofxEasyOscSequenceStats getStats(const ofxEasyOscEndpoint& source) const;
+    size_t getNumSources() const { return sources.size(); }
+    const ofxEasyOscEndpoint& getSource(size_t index) const { return sources[index].from; }
+
+    void clear();
+
+protected:
+    struct Source {
+        ofxEasyOscEndpoint from;
+        uint32_t stream;
+        uint32_t highest; // newest sequence number
+        uint64_t window; // bit n = highest - n has been received
+        ofxEasyOscSequenceStats stats;
+    };
+
+    Source& lookup(const ofxEasyOscEndpoint& from);
+
+    vector<Source> sources;
+    size_t lastIndex;
+    // totals
+    std::atomic<uint64_t> numReceived { 0 };
+    std::atomic<uint64_t> numLost { 0 };
+    std::atomic<uint64_t> numDuplicates { 0 };
+    std::atomic<uint64_t> numReordered { 0 };
+    std::atomic<uint64_t> numDiscarded { 0 };
+};
+
+/* definitions */
+
+inline const vector<char>& ofxEasyOscSequenceHeader::wrap(const char* data, size_t size, uint32_t stream, uint32_t sequence){
+    if (envelope.empty()){
+        // the constant part: "#bundle", time tag 1 (immediately), size of the header message, "/#s" ",ii"
+        envelope.assign(overhead, 0);
+        std::memcpy(envelope.data(), "#bundle", 8);
+        ofxEasyOscWrite64(envelope.data() + 8, 1);
+        ofxEasyOscWrite32(envelope.data() + 16, 16);
+        std::memcpy(envelope.data() + 20, OFXEASYOSC_SEQUENCE_ADDRESS, 4);
+        std::memcpy(envelope.data() + 24, ",ii", 4);
+    }
+    envelope.resize(overhead + size);
+    ofxEasyOscWrite32(envelope.data() + 28, stream);
+    ofxEasyOscWrite32(envelope.data() + 32, sequence);
+    ofxEasyOscWrite32(envelope.data() + 36, static_cast<uint32_t>(size));
+    std::memcpy(envelope.data() + overhead, data, size);
+    return envelope;
+}
+
+inline bool ofxEasyOscSequenceHeader::read(const ofxEasyOscMessageView& msg, uint32_t& stream, uint32_t& sequence){
+    if (msg.getAddressLength() == 3 && std::memcmp(msg.getAddressData(), OFXEASYOSC_SEQUENCE_ADDRESS, 3) == 0
+            && msg.getTypeTagsLength() == 2 && std::memcmp(msg.getTypeTags(), "ii", 2) == 0){
+        stream = static_cast<uint32_t>(msg.getArgAsInt32(0));
+        sequence = static_cast<uint32_t>(msg.getArgAsInt32(1));
+        return true;
+    }
+    return false;
+}
+
+inline ofxEasyOscSequenceTracker::Source& ofxEasyOscSequenceTracker::lookup(const ofxEasyOscEndpoint& from){
+    // usually there are only a few sources and consecutive datagrams come from the same one
+    if (lastIndex < sources.size() && sources[lastIndex].from == from){
+        return sources[lastIndex];
+    }
+    for (size_t i = 0; i < sources.size(); ++i){
+        if (sources[i].from == from){
+            lastIndex = i;
+            return sources[i];
+        }
+    }
+    Source source;
+    source.from = from;
+    source.stream = 0;
+    source.highest = 0;
+    source.window = 0; // not initialized yet
+    sources.push_back(source);
+    lastIndex = sources.size() - 1;
+    return sources.back();
+}
+
+inline ofxEasyOscSequenceResult ofxEasyOscSequenceTracker::track(const ofxEasyOscEndpoint& from, uint32_t stream, uint32_t sequence){
+    Source& source = lookup(from);
+    ++source.stats.numReceived;
+    numReceived.fetch_add(1, std::memory_order_relaxed);
+
+    // first datagram or a new stream (the sender has been restarted)
+    if (!source.window || source.stream != stream){
+        source.stream = stream;
+        source.highest = sequence;
+        source.window = 1;
+        return OFXEASYOSC_SEQUENCE_IN_ORDER;
+    }
+
+    const int32_t distance = static_cast<int32_t>(sequence - source.highest);
+    if (distance > 0){
+        // everything in between is missing (for now)
+        source.stats.numLost += distance - 1;
+        numLost.fetch_add(distance - 1, std::memory_order_relaxed);
+        source.window = distance < 64 ? (source.window << distance) | 1 : 1;
+        source.highest = sequence;
+        return OFXEASYOSC_SEQUENCE_IN_ORDER;
+    }
+
+    const uint32_t age = static_cast<uint32_t>(-static_cast<int64_t>(distance));
+    if (age < 64){
+        const uint64_t bit = uint64_t(1) << age;
+        if (source.window & bit){
+            ++source.stats.numDuplicates;
+            numDuplicates.fetch_add(1, std::memory_order_relaxed);
+            return OFXEASYOSC_SEQUENCE_DUPLICATE;
+        }
+        // a late datagram fills a gap
+        source.window |= bit;
+        if (source.stats.numLost){
+            --source.stats.numLost;
+            numLost.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+    // older than the window we can't tell a late datagram from a duplicate, so it stays counted as lost
+    ++source.stats.numReordered;
+    numReordered.fetch_add(1, std::memory_order_relaxed);
+    return OFXEASYOSC_SEQUENCE_LATE;
+}
+
+inline void ofxEasyOscSequenceTracker::discard(const ofxEasyOscEndpoint& from){
+    ++lookup(from).stats.numDiscarded;
+    numDiscarded.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline ofxEasyOscSequenceStats ofxEasyOscSequenceTracker::getStats() const {
+    ofxEasyOscSequenceStats stats;
+    stats.numReceived = numReceived.load(std::memory_order_relaxed);
+    stats.numLost = numLost.load(std::memory_order_relaxed);
+    stats.numDuplicates = numDuplicates.load(std::memory_order_relaxed);
+    stats.numReordered = numReordered.load(std::memory_order_relaxed);
+    stats.numDiscarded = numDiscarded.load(std::memory_order_relaxed);
+    return stats;
+}
+
+inline ofxEasyOscSequenceStats ofxEasyOscSequenceTracker::getStats(const ofxEasyOscEndpoint& source) const {
+    for (auto& s : sources){
+        if (s.from == source){
+            return s.stats;
+        }
+    }
+    return ofxEasyOscSequenceStats();
+}
+
+inline void ofxEasyOscSequenceTracker::clear(){
+    sources.clear();
+    lastIndex = 0;
+    numReceived = 0;
+    numLost = 0;
+    numDuplicates = 0;
+    numReordered = 0;
+    numDiscarded = 0;
+}
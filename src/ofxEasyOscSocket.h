@@ -0,0 +1,345 @@
+#pragma once
+
+#include <string>
+#include <cstring>
+#include <cstdint>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+#endif
+
+//*-------------------------------------------------------------------------------------------------------*//
+/// ofxEasyOscEndpoint
+
+/// IPv4 address + port of a remote peer (the same address family oscpack/ofxOsc supports).
+
+struct ofxEasyOscEndpoint {
+    ofxEasyOscEndpoint() : address(0), port(0) {}
+
+    // resolve a host name or dotted quad. returns false if the host can't be resolved.
+    bool set(const std::string& host, int portNumber);
+    // dotted quad representation of the address
+    std::string getHost() const;
+    int getPort() const { return port; }
+
+    bool operator==(const ofxEasyOscEndpoint& other) const {
+        return address == other.address && port == other.port;
+    }
+    bool operator!=(const ofxEasyOscEndpoint& other) const {
+        return !(*this == other);
+    }
+
+    uint32_t address; // network byte order
+    uint16_t port; // host byte order
+};
+
+//*-------------------------------------------------------------------------------------------------------*//
+/// ofxEasyOscUdpSocket
+
+/// Minimal non-blocking UDP socket used by ofxEasyOscReceiver.
+
+/// Unlike ofxOscReceiver it doesn't spawn a listener thread and queue messages. Instead the socket is drained
+/// directly in update(), so a headless application can block in wait() (or register getFileDescriptor() with its
+/// own epoll/kqueue/select loop) until data arrives instead of polling.
+/// wakeUp() interrupts a thread blocked in wait(). On Linux this is an eventfd, on other POSIX systems a pipe and
+/// on Windows an empty datagram sent to ourselves (empty datagrams are ignored by receive()).
+
+class ofxEasyOscUdpSocket {
+public:
+#ifdef _WIN32
+    typedef SOCKET Handle;
+#else
+    typedef int Handle;
+#endif
+
+    ofxEasyOscUdpSocket();
+    ~ofxEasyOscUdpSocket();
+
+    ofxEasyOscUdpSocket(const ofxEasyOscUdpSocket&) = delete;
+    ofxEasyOscUdpSocket& operator=(const ofxEasyOscUdpSocket&) = delete;
+
+    // open the socket and bind it to the given port on all interfaces (0 = any free port)
+    bool bind(int portNumber);
+    void close();
+    bool isOpen() const;
+    // the port the socket is bound to
+    int getPort() const { return port; }
+
+    // send a single datagram. returns false on error.
+    bool sendTo(const char* data, size_t size, const ofxEasyOscEndpoint& to);
+    // receive a single datagram without blocking. returns the size or -1 if nothing is waiting.
+    int receive(char* buffer, size_t size, ofxEasyOscEndpoint* from = nullptr);
+
+    // block until a datagram is waiting, wakeUp() is called or the timeout expires (negative = wait forever).
+    // returns true if a datagram is waiting.
+    bool wait(int timeoutMs);
+    // wake up a thread blocked in wait(). can be called from any thread.
+    void wakeUp();
+
+    // native handle, e.g. to add the socket to an external epoll set (level or edge triggered:
+    // receive() is always called until the socket is drained).
+    int getFileDescriptor() const { return static_cast<int>(socket); }
+    // readable whenever wakeUp() has been called (-1 on Windows)
+    int getWakeUpDescriptor() const { return wakeFd[0]; }
+    // consume the wakeUp() calls so far (wait() does this itself)
+    void clearWakeUp();
+
+protected:
+    void closeWakeUp();
+
+    Handle socket;
+    int port;
+    int wakeFd[2];
+};
+
+/* definitions */
+
+#ifdef _WIN32
+#define OFXEASYOSC_INVALID_SOCKET INVALID_SOCKET
+#else
+#define OFXEASYOSC_INVALID_SOCKET -1
+#endif
+
+inline bool ofxEasyOscEndpoint::set(const std::string& host, int portNumber){
+    port = static_cast<uint16_t>(portNumber);
+    in_addr addr;
+    if (inet_pton(AF_INET, host.c_str(), &addr) == 1){
+        address = addr.s_addr;
+        return true;
+    }
+    // not a dotted quad -> resolve host name
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* result = nullptr;
+    if (getaddrinfo(host.c_str(), nullptr, &hints, &result) == 0 && result){
+        address = reinterpret_cast<sockaddr_in*>(result->ai_addr)->sin_addr.s_addr;
+        freeaddrinfo(result);
+        return true;
+    }
+    address = 0;
+    return false;
+}
+
+inline std::string ofxEasyOscEndpoint::getHost() const {
+    char buf[INET_ADDRSTRLEN] = { 0 };
+    in_addr addr;
+    addr.s_addr = address;
+    inet_ntop(AF_INET, &addr, buf, sizeof(buf));
+    return buf;
+}
+
+inline ofxEasyOscUdpSocket::ofxEasyOscUdpSocket() : socket(OFXEASYOSC_INVALID_SOCKET), port(0) {
+    wakeFd[0] = wakeFd[1] = -1;
+#ifdef _WIN32
+    // WSAStartup is reference counted, we never call WSACleanup.
+    static bool initialized = [](){ WSADATA data; return WSAStartup(MAKEWORD(2, 2), &data) == 0; }();
+    (void)initialized;
+#endif
+}
+
+inline ofxEasyOscUdpSocket::~ofxEasyOscUdpSocket(){
+    close();
+}
+
+inline bool ofxEasyOscUdpSocket::bind(int portNumber){
+    close();
+
+    socket = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (socket == OFXEASYOSC_INVALID_SOCKET){
+        return false;
+    }
+
+    // allow several receivers on the same port (like oscpack does)
+    int reuse = 1;
+    setsockopt(socket, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(static_cast<uint16_t>(portNumber));
+    if (::bind(socket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0){
+        close();
+        return false;
+    }
+
+    // get the actual port (in case we bound to port 0)
+    socklen_t len = sizeof(addr);
+    getsockname(socket, reinterpret_cast<sockaddr*>(&addr), &len);
+    port = ntohs(addr.sin_port);
+
+    // non-blocking, so update() can drain the socket
+#ifdef _WIN32
+    u_long nonBlocking = 1;
+    ioctlsocket(socket, FIONBIO, &nonBlocking);
+#else
+    fcntl(socket, F_SETFL, fcntl(socket, F_GETFL, 0) | O_NONBLOCK);
+#endif
+
+    // wake up mechanism
+#if defined(__linux__)
+    wakeFd[0] = wakeFd[1] = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#elif !defined(_WIN32)
+    if (pipe(wakeFd) == 0){
+        fcntl(wakeFd[0], F_SETFL, fcntl(wakeFd[0], F_GETFL, 0) | O_NONBLOCK);
+        fcntl(wakeFd[1], F_SETFL, fcntl(wakeFd[1], F_GETFL, 0) | O_NONBLOCK);
+    } else {
+        wakeFd[0] = wakeFd[1] = -1;
+    }
+#endif
+    return true;
+}
+
+inline void ofxEasyOscUdpSocket::close(){
+    if (socket != OFXEASYOSC_INVALID_SOCKET){
+#ifdef _WIN32
+        closesocket(socket);
+#else
+        ::close(socket);
+#endif
+        socket = OFXEASYOSC_INVALID_SOCKET;
+    }
+    closeWakeUp();
+    port = 0;
+}
+
+inline bool ofxEasyOscUdpSocket::isOpen() const {
+    return socket != OFXEASYOSC_INVALID_SOCKET;
+}
+
+inline bool ofxEasyOscUdpSocket::sendTo(const char* data, size_t size, const ofxEasyOscEndpoint& to){
+    if (!isOpen()){
+        return false;
+    }
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = to.address;
+    addr.sin_port = htons(to.port);
+    return ::sendto(socket, data, static_cast<int>(size), 0,
+                    reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == static_cast<int>(size);
+}
+
+inline int ofxEasyOscUdpSocket::receive(char* buffer, size_t size, ofxEasyOscEndpoint* from){
+    while (isOpen()){
+        sockaddr_in addr;
+        socklen_t len = sizeof(addr);
+        int result = ::recvfrom(socket, buffer, static_cast<int>(size), 0,
+                                reinterpret_cast<sockaddr*>(&addr), &len);
+        if (result > 0){
+            if (from){
+                from->address = addr.sin_addr.s_addr;
+                from->port = ntohs(addr.sin_port);
+            }
+            return result;
+        } else if (result < 0){
+#ifdef _WIN32
+            // ignore ICMP "port unreachable" errors and truncated datagrams
+            int err = WSAGetLastError();
+            if (err != WSAECONNRESET && err != WSAEMSGSIZE){
+                break;
+            }
+#else
+            if (errno != EINTR){
+                break;
+            }
+#endif
+        }
+        // empty datagram (e.g. wake up on Windows) -> try again
+    }
+    return -1;
+}
+
+inline bool ofxEasyOscUdpSocket::wait(int timeoutMs){
+    if (!isOpen()){
+        return false;
+    }
+#ifdef _WIN32
+    WSAPOLLFD fds[1];
+    fds[0].fd = socket;
+    fds[0].events = POLLRDNORM;
+    fds[0].revents = 0;
+    return WSAPoll(fds, 1, timeoutMs) > 0 && (fds[0].revents & POLLRDNORM);
+#else
+    pollfd fds[2];
+    fds[0].fd = socket;
+    fds[0].events = POLLIN;
+    fds[0].revents = 0;
+    fds[1].fd = wakeFd[0];
+    fds[1].events = POLLIN;
+    fds[1].revents = 0;
+    int result;
+    do {
+        result = poll(fds, wakeFd[0] >= 0 ? 2 : 1, timeoutMs);
+    } while (result < 0 && errno == EINTR);
+
+    if (result > 0 && (fds[1].revents & POLLIN)){
+        clearWakeUp();
+    }
+    return result > 0 && (fds[0].revents & POLLIN);
+#endif
+}
+
+inline void ofxEasyOscUdpSocket::wakeUp(){
+#if defined(_WIN32)
+    // send an empty datagram to ourselves
+    ofxEasyOscEndpoint self;
+    self.address = htonl(INADDR_LOOPBACK);
+    self.port = static_cast<uint16_t>(port);
+    sendTo("", 0, self);
+#elif defined(__linux__)
+    if (wakeFd[1] >= 0){
+        uint64_t one = 1;
+        ssize_t result = write(wakeFd[1], &one, sizeof(one));
+        (void)result;
+    }
+#else
+    if (wakeFd[1] >= 0){
+        char c = 0;
+        ssize_t result = write(wakeFd[1], &c, 1);
+        (void)result;
+    }
+#endif
+}
+
+inline void ofxEasyOscUdpSocket::clearWakeUp(){
+#if defined(__linux__)
+    uint64_t value;
+    ssize_t result = read(wakeFd[0], &value, sizeof(value));
+    (void)result;
+#elif !defined(_WIN32)
+    char buf[64];
+    while (read(wakeFd[0], buf, sizeof(buf)) > 0) {}
+#endif
+}
+
+inline void ofxEasyOscUdpSocket::closeWakeUp(){
+#ifndef _WIN32
+    if (wakeFd[0] >= 0){
+        ::close(wakeFd[0]);
+    }
+    if (wakeFd[1] >= 0 && wakeFd[1] != wakeFd[0]){
+        ::close(wakeFd[1]);
+    }
+#endif
+    wakeFd[0] = wakeFd[1] = -1;
+}
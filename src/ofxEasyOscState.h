@@ -0,0 +1,265 @@
+#pragma once
+
+#include "ofxEasyOscAdapter.h"
+#include "ofxEasyOscCodec.h"
+#include "ofxEasyOscSocket.h"
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+/// State snapshots for late joiners (see ofxEasyOscSender::setStateSync() and ofxEasyOscReceiver::requestState()).
+///
+/// The sender keeps the last message of every address it has sent. A receiver which has (re)started sends a "/#q" request
+/// and gets the whole table back as bundles of at most one MTU. Only destinations are answered by default: an 8 byte request
+/// with a spoofed source would otherwise make the sender blast the table at a third party. Other peers can be allowed
+/// (ofxEasyOscSender::setStateOpenRequests()), at most once per interval each and only a few at a time. The first element of every bundle is a "/#y" message
+/// with the part number and the number of parts (int32), the rest are the stored messages.
+/// ofxEasyOscReceiver applies them straight to the registered variables and listeners in one pass.
+
+// address of the request
+#define OFXEASYOSC_STATE_REQUEST "/#q"
+// address of the bundle header
+#define OFXEASYOSC_STATE_ADDRESS "/#y"
+
+struct ofxEasyOscStateStats {
+    ofxEasyOscStateStats() : numRequests(0), numIgnored(0), numBundlesSent(0), numMessagesSent(0), numBundles(0), numApplied(0), numSnapshots(0) {}
+
+    // sender
+    uint64_t numRequests; // snapshots which have been sent (requested or with sendState())
+    uint64_t numIgnored; // requests of other peers which haven't been answered
+    uint64_t numBundlesSent;
+    uint64_t numMessagesSent;
+    // receiver
+    uint64_t numBundles;
+    uint64_t numApplied; // messages for registered addresses
+    uint64_t numSnapshots; // last parts which have arrived
+};
+
+//*-------------------------------------------------------------------------------------------------------*//
+/// ofxEasyOscStateTable
+
+/// Last-value table of ofxEasyOscSender. Snapshots are copied when they are requested and sent in bursts by update(),
+/// so a large table doesn't overflow the receive buffer of the peer. sendTo(data, size, endpoint) sends a bundle.
+
+class ofxEasyOscStateTable {
+public:
+    // "#bundle", time tag, size of the header, "/#y" ",ii" part numParts
+    static const size_t overhead = 16 + 4 + 16;
+    static const size_t requestSize = 8;
+    // other peers which can be answered per interval
+    static const size_t maxPeers = 8;
+
+    ofxEasyOscStateTable() : bEnabled(false), bOpen(false), peerInterval(0), bundleSize(1472), burst(32) {}
+
+    void setEnabled(bool bEnable);
+    bool isEnabled() const { return bEnabled; }
+    // don't store addresses starting with 'prefix' (e.g. cues which must not be replayed)
+    void exclude(const string& prefix);
+    // maximum size of the bundles (larger messages get a bundle of their own)
+    void setBundleSize(size_t bytes) { bundleSize = bytes > overhead + 16 ? bytes : overhead + 16; }
+    size_t getBundleSize() const { return bundleSize; }
+    // bundles per update() call
+    void setBurst(size_t numBundles) { burst = numBundles > 0 ? numBundles : 1; }
+    size_t getNumAddresses() const { return entries.size(); }
+    void clear() { entries.clear(); }
+
+    // remember an encoded message
+    void store(const char* data, size_t size, const char* address, size_t length);
+    // answer peers which aren't destinations, each at most once per 'interval' seconds
+    void setOpen(bool bEnable, double interval);
+    bool isOpen() const { return bOpen; }
+    // returns false if the request of a peer (which isn't a destination) must be ignored. 'now' is in nanoseconds.
+    bool acceptPeer(const ofxEasyOscEndpoint& from, int64_t now);
+    // queue a snapshot of the table for a peer
+    void snapshot(const ofxEasyOscEndpoint& to);
+    bool isSending() const { return !transfers.empty(); }
+    template <typename TSendTo>
+    void update(TSendTo&& sendTo);
+
+    const ofxEasyOscStateStats& getStats() const { return stats; }
+
+    // the request message
+    static bool isRequest(const ofxEasyOscMessageView& msg);
+    static void writeRequest(char* dest);
+    // parse a "/#y" message. returns false if it isn't one.
+    static bool readHeader(const ofxEasyOscMessageView& msg, uint32_t& part, uint32_t& numParts);
+
+protected:
+    struct Transfer {
+        ofxEasyOscEndpoint to;
+        vector<char> data; // the bundles back to back
+        vector<size_t> offsets; // start of every bundle (and the end)
+        size_t next;
+    };
+
+    struct Peer {
+        ofxEasyOscEndpoint from;
+        int64_t time;
+    };
+
+    bool bEnabled;
+    bool bOpen;
+    int64_t peerInterval;
+    vector<Peer> peers; // answered within the interval
+    size_t bundleSize;
+    size_t burst;
+    vector<string> excluded;
+    unordered_map<string, vector<char>> entries;
+    string key; // reused for the lookup
+    vector<Transfer> transfers;
+    ofxEasyOscStateStats stats;
+};
+
+/* definitions */
+
+inline void ofxEasyOscStateTable::setEnabled(bool bEnable){
+    bEnabled = bEnable;
+    if (!bEnable){
+        entries.clear();
+        transfers.clear();
+    }
+}
+
+inline void ofxEasyOscStateTable::setOpen(bool bEnable, double interval){
+    bOpen = bEnable;
+    peerInterval = static_cast<int64_t>(interval * 1e9);
+    peers.clear();
+}
+
+inline bool ofxEasyOscStateTable::acceptPeer(const ofxEasyOscEndpoint& from, int64_t now){
+    if (!bOpen){
+        ++stats.numIgnored;
+        return false;
+    }
+    for (size_t i = 0; i < peers.size();){
+        if (now - peers[i].time >= peerInterval){
+            peers.erase(peers.begin() + i);
+        } else if (peers[i].from == from){
+            ++stats.numIgnored;
+            return false;
+        } else {
+            ++i;
+        }
+    }
+    // spoofed sources are cheap, so the number of peers is limited as well
+    if (peers.size() >= maxPeers){
+        ++stats.numIgnored;
+        return false;
+    }
+    Peer peer;
+    peer.from = from;
+    peer.time = now;
+    peers.push_back(peer);
+    return true;
+}
+
+inline void ofxEasyOscStateTable::exclude(const string& prefix){
+    excluded.push_back(prefix);
+    for (auto it = entries.begin(); it != entries.end();){
+        if (it->first.compare(0, prefix.size(), prefix) == 0){
+            it = entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+inline void ofxEasyOscStateTable::store(const char* data, size_t size, const char* address, size_t length){
+    for (auto& prefix : excluded){
+        if (prefix.size() <= length && std::memcmp(prefix.data(), address, prefix.size()) == 0){
+            return;
+        }
+    }
+    key.assign(address, length);
+    // the vector keeps its capacity, so a known address doesn't allocate
+    entries[key].assign(data, data + size);
+}
+
+inline void ofxEasyOscStateTable::snapshot(const ofxEasyOscEndpoint& to){
+    // a repeated request replaces the pending one
+    for (auto it = transfers.begin(); it != transfers.end(); ++it){
+        if (it->to == to){
+            transfers.erase(it);
+            break;
+        }
+    }
+    Transfer transfer;
+    transfer.to = to;
+    transfer.next = 0;
+    vector<char>& data = transfer.data;
+    size_t bundleStart = 0;
+    size_t numMessages = 0;
+    auto beginBundle = [&](){
+        bundleStart = data.size();
+        transfer.offsets.push_back(bundleStart);
+        data.resize(bundleStart + overhead);
+        char* dest = data.data() + bundleStart;
+        std::memcpy(dest, "#bundle", 8);
+        ofxEasyOscWrite64(dest + 8, 1);
+        ofxEasyOscWrite32(dest + 16, 16);
+        std::memcpy(dest + 20, OFXEASYOSC_STATE_ADDRESS, 4);
+        std::memcpy(dest + 24, ",ii", 4);
+        numMessages = 0;
+    };
+    beginBundle();
+    for (auto& entry : entries){
+        const vector<char>& message = entry.second;
+        if (numMessages && data.size() - bundleStart + 4 + message.size() > bundleSize){
+            beginBundle();
+        }
+        const size_t offset = data.size();
+        data.resize(offset + 4 + message.size());
+        ofxEasyOscWrite32(data.data() + offset, static_cast<uint32_t>(message.size()));
+        std::memcpy(data.data() + offset + 4, message.data(), message.size());
+        ++numMessages;
+        ++stats.numMessagesSent;
+    }
+    transfer.offsets.push_back(data.size());
+    // now the number of parts is known
+    const uint32_t numParts = static_cast<uint32_t>(transfer.offsets.size() - 1);
+    for (uint32_t i = 0; i < numParts; ++i){
+        ofxEasyOscWrite32(data.data() + transfer.offsets[i] + 28, i);
+        ofxEasyOscWrite32(data.data() + transfer.offsets[i] + 32, numParts);
+    }
+    ++stats.numRequests;
+    transfers.push_back(std::move(transfer));
+}
+
+template <typename TSendTo>
+inline void ofxEasyOscStateTable::update(TSendTo&& sendTo){
+    for (size_t i = 0; i < transfers.size();){
+        Transfer& transfer = transfers[i];
+        const size_t numParts = transfer.offsets.size() - 1;
+        for (size_t n = 0; n < burst && transfer.next < numParts; ++n, ++transfer.next){
+            const size_t start = transfer.offsets[transfer.next];
+            sendTo(transfer.data.data() + start, transfer.offsets[transfer.next + 1] - start, transfer.to);
+            ++stats.numBundlesSent;
+        }
+        if (transfer.next == numParts){
+            transfers.erase(transfers.begin() + i);
+        } else {
+            ++i;
+        }
+    }
+}
+
+inline bool ofxEasyOscStateTable::isRequest(const ofxEasyOscMessageView& msg){
+    return msg.getAddressLength() == 3 && std::memcmp(msg.getAddressData(), OFXEASYOSC_STATE_REQUEST, 3) == 0;
+}
+
+inline void ofxEasyOscStateTable::writeRequest(char* dest){
+    std::memset(dest, 0, requestSize);
+    std::memcpy(dest, OFXEASYOSC_STATE_REQUEST, 3);
+    dest[4] = ',';
+}
+
+inline bool ofxEasyOscStateTable::readHeader(const ofxEasyOscMessageView& msg, uint32_t& part, uint32_t& numParts){
+    if (msg.getAddressLength() == 3 && std::memcmp(msg.getAddressData(), OFXEASYOSC_STATE_ADDRESS, 3) == 0
+            && msg.getTypeTagsLength() == 2 && std::memcmp(msg.getTypeTags(), "ii", 2) == 0){
+        part = static_cast<uint32_t>(msg.getArgAsInt32(0));
+        numParts = static_cast<uint32_t>(msg.getArgAsInt32(1));
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,347 @@
+#pragma once
+
+#include "ofxEasyOscAdapter.h"
+#include "ofxEasyOscCodec.h"
+#include "ofxEasyOscDelta.h"
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+/// Receiver driven subscriptions (see ofxEasyOscSender::setSubscriptionFilter() and ofxEasyOscReceiver::setSubscriptions()).
+///
+/// The receiver announces the addresses it has registered (and extra patterns, see ofxEasyOscReceiver::subscribe()) as
+/// "/#u" messages: generation, part and number of parts (int32), followed by the addresses and patterns (strings).
+/// A pattern is either an exact address, a prefix ending with '*' ("/debug/*") or "*" for everything.
+/// The sender interns every address it sends and keeps a bit set per destination, so the check is a single bit test.
+/// The table holds at most maxAddresses addresses; any further ones are matched against the patterns every time they are sent.
+/// Messages nobody wants aren't even serialized. Destinations which haven't announced anything (e.g. plain OSC peers) get everything.
+
+// address of the announcement
+#define OFXEASYOSC_SUBSCRIBE_ADDRESS "/#u"
+
+struct ofxEasyOscSubscriptionStats {
+    ofxEasyOscSubscriptionStats() : numAnnouncements(0), numFiltered(0), numSkipped(0) {}
+
+    uint64_t numAnnouncements; // complete announcements which have been received (sender) or sent (receiver)
+    uint64_t numFiltered; // messages which haven't been serialized because no destination wants them
+    uint64_t numSkipped; // messages which haven't been sent to a destination
+};
+
+//*-------------------------------------------------------------------------------------------------------*//
+/// ofxEasyOscSubscriptionFilter
+
+/// Interest sets of ofxEasyOscSender, per destination.
+
+class ofxEasyOscSubscriptionFilter {
+public:
+    static const uint32_t maxParts = 64;
+    // size of the address table
+    static const size_t maxAddresses = 16384;
+    // returned by lookup() for addresses which don't fit into the table
+    static const uint32_t noId = 0xffffffff;
+
+    ofxEasyOscSubscriptionFilter() : bEnabled(false), numUnknown(0) {}
+
+    void setEnabled(bool bEnable);
+    bool isEnabled() const { return bEnabled; }
+
+    // (re)set the number of destinations
+    void resize(size_t numDestinations);
+
+    // intern an address (once per address). returns noId if the table is full.
+    uint32_t lookup(const char* address, size_t length);
+    // does any destination want the address? 'id' is the result of lookup().
+    bool isWanted(const char* address, size_t length, uint32_t id) const;
+    bool isWanted(size_t destination, uint32_t id, const char* address, size_t length) const {
+        const Channel& channel = channels[destination];
+        return !channel.bKnown || channel.bAll || (id != noId ? test(channel.bits, id) : matches(channel, address, length));
+    }
+    // same for an interned address only (not noId)
+    bool isWanted(size_t destination, uint32_t id) const {
+        const Channel& channel = channels[destination];
+        return !channel.bKnown || channel.bAll || test(channel.bits, id);
+    }
+    // same for an encoded message (also delta messages and keyframes, see ofxEasyOscDelta.h)
+    bool isWanted(size_t destination, const char* data, size_t size);
+
+    // handle an announcement. returns false if the message isn't one. 'bChanged' is set if an announcement is complete.
+    bool receive(const ofxEasyOscMessageView& msg, size_t destination, bool& bChanged);
+    // the destination has announced its interests
+    bool isKnown(size_t destination) const { return channels[destination].bKnown; }
+
+    ofxEasyOscSubscriptionStats& getStats() { return stats; }
+    const ofxEasyOscSubscriptionStats& getStats() const { return stats; }
+
+    // write an announcement as messages of at most 'maxSize' bytes. sendTo(data, size) sends a message.
+    template <typename TSendTo>
+    static void announce(const vector<string>& patterns, uint32_t generation, size_t maxSize, ofxEasyOscWriter& writer, TSendTo&& sendTo);
+
+protected:
+    struct Channel {
+        Channel() : bKnown(false), bAll(false), generation(0), received(0) {}
+        bool bKnown;
+        bool bAll;
+        vector<string> patterns;
+        vector<uint64_t> bits;
+        // announcement which is being assembled
+        uint32_t generation;
+        uint64_t received; // bit n = part n has arrived
+        vector<string> pending;
+    };
+
+    static bool test(const vector<uint64_t>& bits, uint32_t id){
+        return id / 64 < bits.size() && (bits[id / 64] >> (id % 64)) & 1;
+    }
+    static void set(vector<uint64_t>& bits, uint32_t id){
+        if (id / 64 >= bits.size()){
+            bits.resize(id / 64 + 1, 0);
+        }
+        bits[id / 64] |= uint64_t(1) << (id % 64);
+    }
+    static bool matches(const string& pattern, const char* address, size_t length);
+    // does any pattern of the channel match?
+    static bool matches(const Channel& channel, const char* address, size_t length);
+    // recompute the bits of a channel and the union
+    void apply(Channel& channel);
+    void updateAny();
+
+    bool bEnabled;
+    size_t numUnknown; // destinations which get everything
+    vector<Channel> channels;
+    unordered_map<string, uint32_t> ids;
+    vector<string> names;
+    vector<uint64_t> any; // union of all destinations
+    string key; // reused for the lookup
+    ofxEasyOscSubscriptionStats stats;
+};
+
+/* definitions */
+
+inline void ofxEasyOscSubscriptionFilter::setEnabled(bool bEnable){
+    bEnabled = bEnable;
+    // forget the interests, receivers announce them again
+    for (auto& channel : channels){
+        channel = Channel();
+    }
+    numUnknown = channels.size();
+    any.clear();
+}
+
+inline void ofxEasyOscSubscriptionFilter::resize(size_t numDestinations){
+    channels.resize(numDestinations);
+    numUnknown = 0;
+    for (auto& channel : channels){
+        numUnknown += !channel.bKnown || channel.bAll;
+    }
+}
+
+inline uint32_t ofxEasyOscSubscriptionFilter::lookup(const char* address, size_t length){
+    key.assign(address, length);
+    auto it = ids.find(key);
+    if (it != ids.end()){
+        return it->second;
+    }
+    if (names.size() >= maxAddresses){
+        return noId;
+    }
+    const uint32_t id = static_cast<uint32_t>(names.size());
+    ids.emplace(key, id);
+    names.push_back(key);
+    // a new address might match the patterns of a destination
+    for (auto& channel : channels){
+        if (channel.bKnown && !channel.bAll){
+            for (auto& pattern : channel.patterns){
+                if (matches(pattern, key.data(), key.size())){
+                    set(channel.bits, id);
+                    set(any, id);
+                    break;
+                }
+            }
+        }
+    }
+    return id;
+}
+
+inline bool ofxEasyOscSubscriptionFilter::isWanted(const char* address, size_t length, uint32_t id) const {
+    if (numUnknown > 0){
+        return true;
+    } else if (id != noId){
+        return test(any, id);
+    }
+    for (auto& channel : channels){
+        if (matches(channel, address, length)){
+            return true;
+        }
+    }
+    return false;
+}
+
+inline bool ofxEasyOscSubscriptionFilter::isWanted(size_t destination, const char* data, size_t size){
+    const Channel& channel = channels[destination];
+    if (!channel.bKnown || channel.bAll){
+        return true;
+    }
+    ofxEasyOscMessageView msg;
+    if (size >= 8 && std::memcmp(data, "#bundle", 8) == 0){
+        // a keyframe: the message follows the "/#k" header
+        bool bWanted = true;
+        uint32_t frame;
+        ofxEasyOscParsePacket(data, size, [&](const char* d, size_t n){
+            if (msg.parse(d, n) && !ofxEasyOscDeltaDecoder::readKeyframe(msg, frame)){
+                bWanted = isWanted(destination, lookup(msg.getAddressData(), msg.getAddressLength()),
+                                   msg.getAddressData(), msg.getAddressLength());
+            }
+        });
+        return bWanted;
+    }
+    if (!msg.parse(data, size)){
+        return true;
+    }
+    size_t length;
+    const char* address;
+    if (msg.getAddressLength() == 3 && std::memcmp(msg.getAddressData(), OFXEASYOSC_DELTA_ADDRESS, 3) == 0
+            && (address = msg.getArgAsCString(0, &length))){
+        return isWanted(destination, lookup(address, length), address, length);
+    }
+    return isWanted(destination, lookup(msg.getAddressData(), msg.getAddressLength()), msg.getAddressData(), msg.getAddressLength());
+}
+
+inline bool ofxEasyOscSubscriptionFilter::matches(const string& pattern, const char* address, size_t length){
+    if (!pattern.empty() && pattern.back() == '*'){
+        return length >= pattern.size() - 1 && std::memcmp(pattern.data(), address, pattern.size() - 1) == 0;
+    }
+    return pattern.size() == length && std::memcmp(pattern.data(), address, length) == 0;
+}
+
+inline bool ofxEasyOscSubscriptionFilter::matches(const Channel& channel, const char* address, size_t length){
+    if (!channel.bKnown || channel.bAll){
+        return true;
+    }
+    for (auto& pattern : channel.patterns){
+        if (matches(pattern, address, length)){
+            return true;
+        }
+    }
+    return false;
+}
+
+inline bool ofxEasyOscSubscriptionFilter::receive(const ofxEasyOscMessageView& msg, size_t destination, bool& bChanged){
+    if (!(msg.getAddressLength() == 3 && std::memcmp(msg.getAddressData(), OFXEASYOSC_SUBSCRIBE_ADDRESS, 3) == 0
+            && msg.getTypeTagsLength() >= 3 && std::memcmp(msg.getTypeTags(), "iii", 3) == 0)){
+        return false;
+    }
+    bChanged = false;
+    Channel& channel = channels[destination];
+    const uint32_t generation = static_cast<uint32_t>(msg.getArgAsInt32(0));
+    const uint32_t part = static_cast<uint32_t>(msg.getArgAsInt32(1));
+    const uint32_t numParts = static_cast<uint32_t>(msg.getArgAsInt32(2));
+    if (numParts == 0 || numParts > maxParts || part >= numParts){
+        return true;
+    }
+    if (generation != channel.generation || !channel.received){
+        // a new announcement (an old one which is incomplete is dropped)
+        channel.generation = generation;
+        channel.received = 0;
+        channel.pending.clear();
+    }
+    if ((channel.received >> part) & 1){
+        return true;
+    }
+    channel.received |= uint64_t(1) << part;
+    for (int i = 3; i < msg.getNumArgs(); ++i){
+        size_t length;
+        if (const char* pattern = msg.getArgAsCString(i, &length)){
+            channel.pending.emplace_back(pattern, length);
+        }
+    }
+    const uint64_t complete = numParts == 64 ? ~uint64_t(0) : (uint64_t(1) << numParts) - 1;
+    if (channel.received == complete){
+        channel.received = 0;
+        ++stats.numAnnouncements;
+        // receivers repeat their announcements, usually nothing has changed
+        if (!channel.bKnown || channel.pending != channel.patterns){
+            channel.patterns.swap(channel.pending);
+            apply(channel);
+            bChanged = true;
+        }
+        channel.pending.clear();
+    }
+    return true;
+}
+
+inline void ofxEasyOscSubscriptionFilter::apply(Channel& channel){
+    channel.bKnown = true;
+    channel.bAll = false;
+    channel.bits.assign((names.size() + 63) / 64, 0);
+    for (auto& pattern : channel.patterns){
+        if (pattern.empty()){
+            continue;
+        } else if (pattern == "*"){
+            channel.bAll = true;
+        } else if (pattern.back() == '*'){
+            for (uint32_t id = 0; id < names.size(); ++id){
+                if (matches(pattern, names[id].data(), names[id].size())){
+                    set(channel.bits, id);
+                }
+            }
+        } else {
+            // intern it, so the address doesn't have to be matched when it's sent for the first time
+            auto it = ids.find(pattern);
+            const uint32_t id = it != ids.end() ? it->second : lookup(pattern.data(), pattern.size());
+            if (id != noId){
+                set(channel.bits, id);
+            }
+        }
+    }
+    updateAny();
+}
+
+inline void ofxEasyOscSubscriptionFilter::updateAny(){
+    numUnknown = 0;
+    any.assign((names.size() + 63) / 64, 0);
+    for (auto& channel : channels){
+        if (!channel.bKnown || channel.bAll){
+            ++numUnknown;
+        } else {
+            for (size_t i = 0; i < channel.bits.size() && i < any.size(); ++i){
+                any[i] |= channel.bits[i];
+            }
+        }
+    }
+}
+
+template <typename TSendTo>
+inline void ofxEasyOscSubscriptionFilter::announce(const vector<string>& patterns, uint32_t generation, size_t maxSize,
+                                                   ofxEasyOscWriter& writer, TSendTo&& sendTo){
+    // split the patterns into parts: address, 3 ints and the type tags (the size estimate errs on the safe side)
+    vector<size_t> starts(1, 0);
+    size_t size = 32;
+    for (size_t i = 0; i < patterns.size(); ++i){
+        const size_t n = ((patterns[i].size() + 4) & ~size_t(3)) + 1;
+        if (size + n > maxSize && i > starts.back()){
+            starts.push_back(i);
+            size = 32;
+        }
+        size += n;
+    }
+    if (starts.size() > maxParts){
+        // too many patterns, ask for everything instead
+        announce(vector<string>(1, "*"), generation, maxSize, writer, sendTo);
+        return;
+    }
+    starts.push_back(patterns.size());
+    const uint32_t numParts = static_cast<uint32_t>(starts.size() - 1);
+    for (uint32_t part = 0; part < numParts; ++part){
+        writer.begin(OFXEASYOSC_SUBSCRIBE_ADDRESS, 3, 3 + starts[part + 1] - starts[part]);
+        writer.addInt32(static_cast<int32_t>(generation));
+        writer.addInt32(static_cast<int32_t>(part));
+        writer.addInt32(static_cast<int32_t>(numParts));
+        for (size_t i = starts[part]; i < starts[part + 1]; ++i){
+            writer.addString(patterns[i]);
+        }
+        if (writer.end()){
+            sendTo(writer.data(), writer.size());
+        }
+    }
+}
@@ -1,10 +1,15 @@
 #pragma once
 
-#include "ofMain.h"
-#include "ofxOsc.h"
+#include "ofxEasyOscAdapter.h"
+#include "ofxEasyOscCodec.h"
+// bump allocator for pmr arguments
+#include "ofxEasyOscArena.h"
+// quantized float arrays
+#include "ofxEasyOscQuantize.h"
+#include <bitset>
+#include <cstdio>
 #include <functional>
 #include <type_traits>
-#include <typeinfo>
 
 //*--------------------------------------------------------------------------------------------------*//
 
@@ -12,81 +17,491 @@
 /// which all inherit from a single abstract base class, so they can be stored inside a STL container.
 /// Correct dispatching of OSC messages is handled via template specialization of the getData() method.
 
+/// ofxEasyOscArgTraits
+
+/// Describes which OSC arguments a variable/function argument type can be read from.
+/// 'supported' is checked at compile time (unsupported types don't compile), 'count' is the number of arguments the type consumes
+/// (0 = any number, in steps of 'step') and accepts() tells if an argument with the given type tag can be converted.
+/// Used to validate the type signatures of ofxEasyOscAddress at compile time.
+
+template <typename T>
+struct ofxEasyOscArgTraits {
+    static const bool supported = false;
+    static const int count = 0;
+    static const int step = 1;
+    static constexpr bool accepts(char tag) { return false; }
+};
+
+// numbers (converted from each other)
+struct ofxEasyOscNumberTraits {
+    static const bool supported = true;
+    static const int count = 1;
+    static const int step = 1;
+    static constexpr bool accepts(char tag) {
+        return tag == 'i' || tag == 'h' || tag == 'f' || tag == 'd' || tag == 'T' || tag == 'F';
+    }
+};
+
+// 64-bit integers (can also hold a time tag)
+struct ofxEasyOscInt64Traits : ofxEasyOscNumberTraits {
+    static constexpr bool accepts(char tag) { return tag == 't' || ofxEasyOscNumberTraits::accepts(tag); }
+};
+
+// vectors and matrices (N numbers)
+template <int N>
+struct ofxEasyOscVecTraits : ofxEasyOscNumberTraits {
+    static const int count = N;
+};
+
+// types which take the whole message
+struct ofxEasyOscAnyTraits {
+    static const bool supported = true;
+    static const int count = 0;
+    static const int step = 1;
+    static constexpr bool accepts(char /*tag*/) { return true; }
+};
+
+template <> struct ofxEasyOscArgTraits<bool> : ofxEasyOscNumberTraits {};
+template <> struct ofxEasyOscArgTraits<unsigned char> : ofxEasyOscNumberTraits {};
+template <> struct ofxEasyOscArgTraits<int> : ofxEasyOscNumberTraits {};
+template <> struct ofxEasyOscArgTraits<float> : ofxEasyOscNumberTraits {};
+template <> struct ofxEasyOscArgTraits<double> : ofxEasyOscNumberTraits {};
+template <> struct ofxEasyOscArgTraits<long> : ofxEasyOscInt64Traits {};
+template <> struct ofxEasyOscArgTraits<long long> : ofxEasyOscInt64Traits {};
+template <> struct ofxEasyOscArgTraits<ofVec2f> : ofxEasyOscVecTraits<2> {};
+template <> struct ofxEasyOscArgTraits<ofVec3f> : ofxEasyOscVecTraits<3> {};
+template <> struct ofxEasyOscArgTraits<ofVec4f> : ofxEasyOscVecTraits<4> {};
+template <> struct ofxEasyOscArgTraits<ofMatrix3x3> : ofxEasyOscVecTraits<9> {};
+template <> struct ofxEasyOscArgTraits<ofMatrix4x4> : ofxEasyOscVecTraits<16> {};
+template <> struct ofxEasyOscArgTraits<ofxOscMessage> : ofxEasyOscAnyTraits {};
+// functions only
+template <> struct ofxEasyOscArgTraits<ofxEasyOscMessageView> : ofxEasyOscAnyTraits {};
+// functions without arguments
+template <> struct ofxEasyOscArgTraits<void> : ofxEasyOscAnyTraits {};
+
+template <>
+struct ofxEasyOscArgTraits<ofxEasyOscTimetag> : ofxEasyOscNumberTraits {
+    static constexpr bool accepts(char tag) { return tag == 't' || tag == 'h'; }
+};
+
+// strings (numbers are formatted)
+template <>
+struct ofxEasyOscArgTraits<string> : ofxEasyOscNumberTraits {
+    static constexpr bool accepts(char tag) {
+        return tag == 's' || tag == 'S' || tag == 'i' || tag == 'h' || tag == 'f' || tag == 'd';
+    }
+};
+
+#ifdef OFXEASYOSC_HAS_STRING_VIEW
+template <>
+struct ofxEasyOscArgTraits<std::string_view> : ofxEasyOscNumberTraits {
+    static constexpr bool accepts(char tag) { return tag == 's' || tag == 'S'; }
+};
+#endif
+
+#ifdef OFXEASYOSC_HAS_PMR
+template <>
+struct ofxEasyOscArgTraits<std::pmr::string> : ofxEasyOscArgTraits<string> {};
+#endif
+
+// types which are constructed from the receiver's arena (std::pmr::string, std::pmr::vector<T>...)
+template <typename T>
+struct ofxEasyOscUsesArena {
+#ifdef OFXEASYOSC_HAS_PMR
+    static const bool value = std::uses_allocator<T, std::pmr::polymorphic_allocator<char>>::value;
+#else
+    static const bool value = false;
+#endif
+};
+
+// containers: any number of elements (floats, vectors and matrices also from a quantized blob)
+template <typename T, typename Allocator, template <typename, typename> class Container>
+struct ofxEasyOscArgTraits<Container<T, Allocator>> {
+    static const bool supported = ofxEasyOscArgTraits<T>::supported && ofxEasyOscArgTraits<T>::count > 0;
+    static const int count = 0;
+    static const int step = ofxEasyOscArgTraits<T>::count;
+    static constexpr bool accepts(char tag) { return ofxEasyOscArgTraits<T>::accepts(tag) || (tag == 'b' && ofxEasyOscIsQuantizable<T>::value); }
+};
+
+// containers of bools and bitsets (also a bit-packed blob)
+template <typename Allocator, template <typename, typename> class Container>
+struct ofxEasyOscArgTraits<Container<bool, Allocator>> : ofxEasyOscAnyTraits {
+    static constexpr bool accepts(char tag) { return tag == 'b' || ofxEasyOscNumberTraits::accepts(tag); }
+};
+
+template <size_t N>
+struct ofxEasyOscArgTraits<std::bitset<N>> : ofxEasyOscArgTraits<vector<bool>> {};
+
+// check that all type tags are accepted
+template <typename T, char... Tags>
+struct ofxEasyOscAcceptsTags {
+    static const bool value = true;
+};
+
+template <typename T, char Tag, char... Tags>
+struct ofxEasyOscAcceptsTags<T, Tag, Tags...> {
+    static const bool value = ofxEasyOscArgTraits<T>::accepts(Tag) && ofxEasyOscAcceptsTags<T, Tags...>::value;
+};
+
+// check if a (decayed) argument type can be read from a message with the given type tags
+template <typename T, char... Tags>
+struct ofxEasyOscMatchesSignature {
+    typedef ofxEasyOscArgTraits<T> traits;
+    static const bool value = traits::supported && ofxEasyOscAcceptsTags<T, Tags...>::value
+        && (traits::count ? sizeof...(Tags) == size_t(traits::count) : sizeof...(Tags) % traits::step == 0);
+};
+
+// convert a received message into an ofxOscMessage
+inline void ofxEasyOscCopyMessage(const ofxEasyOscMessageView& msg, ofxOscMessage& dest);
+
+//*--------------------------------------------------------------------------------------------------*//
+
+/// ofxEasyOscMessagePool
+
+/// Provides the ofxOscMessage objects which are passed to listeners taking an ofxOscMessage (e.g. the default listener).
+/// The receiver opens a Scope for every message it dispatches. The message is converted the first time a listener asks for it
+/// (getMessage()) and then shared by const reference between all listeners of that message, so listeners which don't need an
+/// ofxOscMessage never pay for one. Listeners taking a non-const reference get a private copy (acquire()/release()).
+/// Messages are recycled, so the pool only grows if dispatching is nested (a listener calling update() again). Together with the
+/// argument slot reuse of the headless ofxOscMessage the receive path doesn't allocate in its steady state
+/// (openFrameworks' ofxOscMessage still allocates its arguments).
+
+class ofxEasyOscMessagePool {
+public:
+    ofxEasyOscMessagePool() : used(0), numAcquired(0), numConverted(0) {}
+
+    // dispatch scope of a single message
+    class Scope {
+    public:
+        Scope(ofxEasyOscMessagePool& pool_, const ofxEasyOscMessageView& msg) : pool(pool_) { pool.begin(msg); }
+        ~Scope() { pool.end(); }
+    protected:
+        ofxEasyOscMessagePool& pool;
+    };
+
+    // the message of the current scope, converted on first use
+    const ofxOscMessage& getMessage();
+
+    // get a cleared message
+    ofxOscMessage& acquire();
+    // give back the most recently acquired message
+    void release();
+
+    // number of message objects which have been created
+    size_t getNumAllocated() const { return messages.size(); }
+    // number of acquire() calls
+    uint64_t getNumAcquired() const { return numAcquired; }
+    // number of conversions from ofxEasyOscMessageView to ofxOscMessage
+    uint64_t getNumConverted() const { return numConverted; }
+
+    // true while a message is being dispatched
+    bool isDispatching() const { return !levels.empty(); }
+
+#ifdef OFXEASYOSC_HAS_PMR
+    // memory for temporary pmr arguments, reset by ofxEasyOscReceiver::update()
+    ofxEasyOscArena& getArena() { return arena; }
+    const ofxEasyOscArena& getArena() const { return arena; }
+#endif
+
+protected:
+    void begin(const ofxEasyOscMessageView& msg);
+    void end();
+
+    struct Level {
+        const ofxEasyOscMessageView* view;
+        ofxOscMessage* message; // nullptr until converted
+    };
+    vector<Level> levels;
+    vector<unique_ptr<ofxOscMessage>> messages;
+    size_t used;
+    uint64_t numAcquired;
+    uint64_t numConverted;
+#ifdef OFXEASYOSC_HAS_PMR
+    ofxEasyOscArena arena;
+#endif
+};
+
+inline void ofxEasyOscMessagePool::begin(const ofxEasyOscMessageView& msg){
+    Level level;
+    level.view = &msg;
+    level.message = nullptr;
+    levels.push_back(level);
+}
+
+inline void ofxEasyOscMessagePool::end(){
+    if (levels.back().message){
+        release();
+    }
+    levels.pop_back();
+}
+
+inline const ofxOscMessage& ofxEasyOscMessagePool::getMessage(){
+    Level& level = levels.back();
+    if (!level.message){
+        level.message = &acquire();
+        ofxEasyOscCopyMessage(*level.view, *level.message);
+        ++numConverted;
+    }
+    return *level.message;
+}
+
+inline ofxOscMessage& ofxEasyOscMessagePool::acquire(){
+    ++numAcquired;
+    if (used == messages.size()){
+        messages.push_back(unique_ptr<ofxOscMessage>(new ofxOscMessage()));
+    }
+    ofxOscMessage& msg = *messages[used++];
+    msg.clear();
+    return msg;
+}
+
+inline void ofxEasyOscMessagePool::release(){
+    if (used > 0){
+        --used;
+    }
+}
+
+//*--------------------------------------------------------------------------------------------------*//
+
 /// ofxOscListener
 
 class ofxOscListener {
 public:
     virtual ~ofxOscListener() {}
     // generic dispatch method, implemented differently for ofxOscVariable and ofxOscMemberFunction
-    virtual void dispatch(const ofxOscMessage& msg) = 0;
+    virtual void dispatch(const ofxEasyOscMessageView& msg, ofxEasyOscMessagePool& pool) = 0;
     virtual bool compare(ofxOscListener* listener) = 0;
     virtual bool isLambda() {
         return false;
     }
 protected:
+    // storage for function arguments (T is the declared argument type): a value initialized local by default,
+    // see the specializations for ofxOscMessage, ofxEasyOscMessageView and pmr types
+    template <typename T, typename TDecayed = typename std::decay<T>::type, bool bArena = ofxEasyOscUsesArena<TDecayed>::value>
+    struct Argument {
+        Argument(const ofxEasyOscMessageView& msg, ofxEasyOscMessagePool&) : value() {
+            getData(msg, 0, value);
+        }
+        TDecayed value;
+    };
+
     // get single argument (allowed types)
-    void getData(const ofxOscMessage&, int index, ofxOscMessage& dest);
-    void getData(const ofxOscMessage&, int index, bool& dest);
-    void getData(const ofxOscMessage&, int index, unsigned char& dest);
-    void getData(const ofxOscMessage&, int index, int& dest);
-    void getData(const ofxOscMessage&, int index, float& dest);
-    void getData(const ofxOscMessage&, int index, double& dest);
-    void getData(const ofxOscMessage&, int index, string& dest);
-    void getData(const ofxOscMessage&, int index, ofVec2f& dest);
-    void getData(const ofxOscMessage&, int index, ofVec3f& dest);
-    void getData(const ofxOscMessage&, int index, ofVec4f& dest);
-    void getData(const ofxOscMessage&, int index, ofMatrix3x3& dest);
-    void getData(const ofxOscMessage&, int index, ofMatrix4x4& dest);
-    // catches bad types at runtime (to prevent cryptic compilation errors).
+    static void getData(const ofxEasyOscMessageView&, int index, ofxOscMessage& dest);
+    static void getData(const ofxEasyOscMessageView&, int index, bool& dest);
+    static void getData(const ofxEasyOscMessageView&, int index, unsigned char& dest);
+    static void getData(const ofxEasyOscMessageView&, int index, int& dest);
+    static void getData(const ofxEasyOscMessageView&, int index, float& dest);
+    static void getData(const ofxEasyOscMessageView&, int index, double& dest);
+    static void getData(const ofxEasyOscMessageView&, int index, long& dest);
+    static void getData(const ofxEasyOscMessageView&, int index, long long& dest);
+    static void getData(const ofxEasyOscMessageView&, int index, ofxEasyOscTimetag& dest);
+    static void getData(const ofxEasyOscMessageView&, int index, string& dest);
+#ifdef OFXEASYOSC_HAS_STRING_VIEW
+    // points into the packet (only valid during dispatch)
+    static void getData(const ofxEasyOscMessageView&, int index, std::string_view& dest);
+#endif
+#ifdef OFXEASYOSC_HAS_PMR
+    // allocated from the arena the string/vector was constructed with
+    static void getData(const ofxEasyOscMessageView&, int index, std::pmr::string& dest);
+    template <typename T>
+    static void getData(const ofxEasyOscMessageView& msg, int index, std::pmr::vector<T>& dest);
+#endif
+    static void getData(const ofxEasyOscMessageView&, int index, ofVec2f& dest);
+    static void getData(const ofxEasyOscMessageView&, int index, ofVec3f& dest);
+    static void getData(const ofxEasyOscMessageView&, int index, ofVec4f& dest);
+    static void getData(const ofxEasyOscMessageView&, int index, ofMatrix3x3& dest);
+    static void getData(const ofxEasyOscMessageView&, int index, ofMatrix4x4& dest);
+    // catches bad types at compile time (instead of a cryptic overload resolution error).
     template<typename T>
-    void getData(const ofxOscMessage& msg, int index, T& dest){
-        // see template specializations for 'allowed' types
-        cout << "Bad argument type for variable/function argument " << typeid(dest).name() << "!\n";
+    static void getData(const ofxEasyOscMessageView& msg, int index, T& dest){
+        // see the overloads above and ofxEasyOscArgTraits for 'allowed' types
+        static_assert(ofxEasyOscArgTraits<T>::supported, "ofxEasyOsc: bad argument type for variable/function argument");
     }
 
     // get container of simple one-dimensional types
     template <typename T, template <typename E, typename Allocater = std::allocator<E>> class Container>
-    void getData(const ofxOscMessage& msg, int index, Container<T>& dest);
+    static void getData(const ofxEasyOscMessageView& msg, int index, Container<T>& dest);
+
+    // get container of floats (also from a quantized blob)
+    template <template <typename E, typename Allocater = std::allocator<E>> class Container>
+    static void getData(const ofxEasyOscMessageView& msg, int index, Container<float>& dest);
+
+    // get container of bools (also from a bit-packed blob)
+    template <template <typename E, typename Allocater = std::allocator<E>> class Container>
+    static void getData(const ofxEasyOscMessageView& msg, int index, Container<bool>& dest);
+
+    // get std::bitset (also from a bit-packed blob)
+    template <size_t N>
+    static void getData(const ofxEasyOscMessageView& msg, int index, std::bitset<N>& dest);
 
     // get container of ofVec2f objects
     template <template <typename E, typename Allocater = std::allocator<E>> class Container>
-    void getData(const ofxOscMessage& msg, int index, Container<ofVec2f>& dest){
+    static void getData(const ofxEasyOscMessageView& msg, int index, Container<ofVec2f>& dest){
         getVec(msg, dest, 2);
     }
     // get container of ofVec3f objects
     template <template <typename E, typename Allocater = std::allocator<E>> class Container>
-    void getData(const ofxOscMessage& msg, int index, Container<ofVec3f>& dest){
+    static void getData(const ofxEasyOscMessageView& msg, int index, Container<ofVec3f>& dest){
         getVec(msg, dest, 3);
     }
     // get container of ofVec4f objects
     template <template <typename E, typename Allocater = std::allocator<E>> class Container>
-    void getData(const ofxOscMessage& msg, int index, Container<ofVec4f>& dest){
+    static void getData(const ofxEasyOscMessageView& msg, int index, Container<ofVec4f>& dest){
         getVec(msg, dest, 4);
     }
     // get container of ofMatrix3x3 objects
     template <template <typename E, typename Allocater = std::allocator<E>> class Container>
-    void getData(const ofxOscMessage& msg, int index, Container<ofMatrix3x3>& dest){
+    static void getData(const ofxEasyOscMessageView& msg, int index, Container<ofMatrix3x3>& dest){
         getVec(msg, dest, 9);
     }
     // get container of ofMatrix4x4 objects
     template <template <typename E, typename Allocater = std::allocator<E>> class Container>
-    void getData(const ofxOscMessage& msg, int index, Container<ofMatrix4x4>& dest){
-        getVec(msg, dest, 12);
+    static void getData(const ofxEasyOscMessageView& msg, int index, Container<ofMatrix4x4>& dest){
+        getVec(msg, dest, 16);
     }
 
+    // helper function for std::string and std::pmr::string
+    template <typename TString>
+    static void getString(const ofxEasyOscMessageView& msg, int index, TString& dest);
+
     // helper function for lists of ofVec2f, ofVec3f, ofVec4f, ofMatrix3x3 and ofMatrix4x4
     template <typename TVec, template <typename E, typename Allocater = std::allocator<E>> class Container>
-    void getVec(const ofxOscMessage& msg, Container<TVec>& dest, const int size);
+    static void getVec(const ofxEasyOscMessageView& msg, Container<TVec>& dest, const int size);
+
+    // decode a quantized blob into a container of floats/vectors/matrices ('size' floats per element).
+    // returns false if the first argument isn't a quantized blob.
+    template <typename TContainer>
+    static bool getQuantized(const ofxEasyOscMessageView& msg, TContainer& dest, size_t size);
 };
 
+// const reference (or copy) of the message which is shared by all listeners
+template <typename T>
+struct ofxOscListener::Argument<T, ofxOscMessage> {
+    Argument(const ofxEasyOscMessageView&, ofxEasyOscMessagePool& pool) : value(pool.getMessage()) {}
+    const ofxOscMessage& value;
+};
+
+// non-const reference: private copy
+template <>
+struct ofxOscListener::Argument<ofxOscMessage&, ofxOscMessage> {
+    Argument(const ofxEasyOscMessageView& msg, ofxEasyOscMessagePool& pool_) : pool(pool_), value(pool_.acquire()) {
+        getData(msg, 0, value);
+    }
+    ~Argument() { pool.release(); }
+    ofxEasyOscMessagePool& pool;
+    ofxOscMessage& value;
+};
+
+// the received message itself (no conversion at all)
+template <typename T>
+struct ofxOscListener::Argument<T, ofxEasyOscMessageView> {
+    Argument(const ofxEasyOscMessageView& msg, ofxEasyOscMessagePool&) : value(msg) {}
+    const ofxEasyOscMessageView& value;
+};
+
+#ifdef OFXEASYOSC_HAS_PMR
+// pmr containers are constructed from the arena
+template <typename T, typename TDecayed>
+struct ofxOscListener::Argument<T, TDecayed, true> {
+    Argument(const ofxEasyOscMessageView& msg, ofxEasyOscMessagePool& pool) : value(&pool.getArena()) {
+        getData(msg, 0, value);
+    }
+    TDecayed value;
+};
+#endif
+
 /* implementation */
 
-// simply pass the OSC message
-inline void ofxOscListener::getData(const ofxOscMessage& msg, int index, ofxOscMessage& dest) {
-    dest = msg;
+// convert the OSC message
+inline void ofxOscListener::getData(const ofxEasyOscMessageView& msg, int /*index*/, ofxOscMessage& dest) {
+    ofxEasyOscCopyMessage(msg, dest);
 }
 
-inline void ofxOscListener::getData(const ofxOscMessage& msg, int index, bool& dest) {
+inline void ofxEasyOscCopyMessage(const ofxEasyOscMessageView& msg, ofxOscMessage& dest) {
+    dest.clear();
+#ifdef OFXEASYOSC_HEADLESS
+    // no temporary strings
+    dest.setAddress(msg.getAddressData(), msg.getAddressLength());
+#else
+    dest.setAddress(msg.getAddress());
+#endif
+    dest.setRemoteEndpoint(msg.getRemoteHost(), msg.getRemotePort());
+
+    for (int i = 0; i < msg.getNumArgs(); ++i){
+        switch (msg.getArgType(i)){
+        case OFXOSC_TYPE_INT32:
+            dest.addIntArg(msg.getArgAsInt32(i));
+            break;
+        case OFXOSC_TYPE_INT64:
+            dest.addInt64Arg(msg.getArgAsInt64(i));
+            break;
+        case OFXOSC_TYPE_FLOAT:
+            dest.addFloatArg(msg.getArgAsFloat(i));
+            break;
+        case OFXOSC_TYPE_DOUBLE:
+            dest.addDoubleArg(msg.getArgAsDouble(i));
+            break;
+#ifdef OFXEASYOSC_HEADLESS
+        case OFXOSC_TYPE_STRING: {
+            size_t length;
+            const char* str = msg.getArgAsCString(i, &length);
+            dest.addStringArg(str, length);
+            break;
+        }
+        case OFXOSC_TYPE_SYMBOL: {
+            size_t length;
+            const char* str = msg.getArgAsCString(i, &length);
+            dest.addSymbolArg(str, length);
+            break;
+        }
+#else
+        case OFXOSC_TYPE_STRING:
+            dest.addStringArg(msg.getArgAsString(i));
+            break;
+        case OFXOSC_TYPE_SYMBOL:
+            dest.addSymbolArg(msg.getArgAsSymbol(i));
+            break;
+#endif
+        case OFXOSC_TYPE_CHAR:
+            dest.addCharArg(msg.getArgAsChar(i));
+            break;
+        case OFXOSC_TYPE_MIDI_MESSAGE:
+            dest.addMidiMessageArg(msg.getArgAsMidiMessage(i));
+            break;
+        case OFXOSC_TYPE_TRUE:
+        case OFXOSC_TYPE_FALSE:
+            dest.addBoolArg(msg.getArgAsBool(i));
+            break;
+        case OFXOSC_TYPE_NONE:
+            dest.addNoneArg();
+            break;
+        case OFXOSC_TYPE_TRIGGER:
+            dest.addTriggerArg();
+            break;
+        case OFXOSC_TYPE_TIMETAG:
+            dest.addTimetagArg(msg.getArgAsTimetag(i));
+            break;
+        case OFXOSC_TYPE_RGBA_COLOR:
+            dest.addRgbaColorArg(msg.getArgAsRgbaColor(i));
+            break;
+        case OFXOSC_TYPE_BLOB: {
+#ifdef OFXEASYOSC_HEADLESS
+            const char* blobData;
+            size_t blobSize;
+            msg.getArgAsBlob(i, blobData, blobSize);
+            dest.addBlobArg(blobData, blobSize);
+#else
+            dest.addBlobArg(msg.getArgAsBlob(i));
+#endif
+            break;
+        }
+        default:
+            break;
+        }
+    }
+}
+
+inline void ofxOscListener::getData(const ofxEasyOscMessageView& msg, int index, bool& dest) {
     if (msg.getNumArgs()){
         switch (msg.getArgType(index)){
         case OFXOSC_TYPE_FLOAT:
@@ -95,6 +510,16 @@ inline void ofxOscListener::getData(const ofxOscMessage& msg, int index, bool& d
         case OFXOSC_TYPE_INT32:
             dest = msg.getArgAsInt32(index);
             break;
+        case OFXOSC_TYPE_INT64:
+            dest = msg.getArgAsInt64(index) != 0;
+            break;
+        case OFXOSC_TYPE_DOUBLE:
+            dest = msg.getArgAsDouble(index) != 0;
+            break;
+        case OFXOSC_TYPE_TRUE:
+        case OFXOSC_TYPE_FALSE:
+            dest = msg.getArgAsBool(index);
+            break;
         default:
             dest = false;
             break;
@@ -102,7 +527,7 @@ inline void ofxOscListener::getData(const ofxOscMessage& msg, int index, bool& d
     }
 }
 
-inline void ofxOscListener::getData(const ofxOscMessage& msg, int index, unsigned char& dest) {
+inline void ofxOscListener::getData(const ofxEasyOscMessageView& msg, int index, unsigned char& dest) {
     if (msg.getNumArgs()){
         switch (msg.getArgType(index)){
         case OFXOSC_TYPE_FLOAT:
@@ -111,6 +536,16 @@ inline void ofxOscListener::getData(const ofxOscMessage& msg, int index, unsigne
         case OFXOSC_TYPE_INT32:
             dest = msg.getArgAsInt32(index);
             break;
+        case OFXOSC_TYPE_INT64:
+            dest = static_cast<unsigned char>(msg.getArgAsInt64(index));
+            break;
+        case OFXOSC_TYPE_DOUBLE:
+            dest = static_cast<unsigned char>(msg.getArgAsDouble(index));
+            break;
+        case OFXOSC_TYPE_TRUE:
+        case OFXOSC_TYPE_FALSE:
+            dest = msg.getArgAsBool(index);
+            break;
         default:
             dest = 0;
             break;
@@ -118,7 +553,7 @@ inline void ofxOscListener::getData(const ofxOscMessage& msg, int index, unsigne
     }
 }
 
-inline void ofxOscListener::getData(const ofxOscMessage& msg, int index, int& dest) {
+inline void ofxOscListener::getData(const ofxEasyOscMessageView& msg, int index, int& dest) {
     if (msg.getNumArgs()){
         switch (msg.getArgType(index)){
         case OFXOSC_TYPE_FLOAT:
@@ -127,6 +562,16 @@ inline void ofxOscListener::getData(const ofxOscMessage& msg, int index, int& de
         case OFXOSC_TYPE_INT32:
             dest = msg.getArgAsInt32(index);
             break;
+        case OFXOSC_TYPE_INT64:
+            dest = static_cast<int>(msg.getArgAsInt64(index));
+            break;
+        case OFXOSC_TYPE_DOUBLE:
+            dest = static_cast<int>(msg.getArgAsDouble(index));
+            break;
+        case OFXOSC_TYPE_TRUE:
+        case OFXOSC_TYPE_FALSE:
+            dest = msg.getArgAsBool(index);
+            break;
         default:
             dest = 0;
             break;
@@ -134,7 +579,7 @@ inline void ofxOscListener::getData(const ofxOscMessage& msg, int index, int& de
     }
 }
 
-inline void ofxOscListener::getData(const ofxOscMessage& msg, int index, float& dest) {
+inline void ofxOscListener::getData(const ofxEasyOscMessageView& msg, int index, float& dest) {
     if (msg.getNumArgs()){
         switch (msg.getArgType(index)){
         case OFXOSC_TYPE_FLOAT:
@@ -143,6 +588,16 @@ inline void ofxOscListener::getData(const ofxOscMessage& msg, int index, float&
         case OFXOSC_TYPE_INT32:
             dest = static_cast<float>(msg.getArgAsInt32(index));
             break;
+        case OFXOSC_TYPE_INT64:
+            dest = static_cast<float>(msg.getArgAsInt64(index));
+            break;
+        case OFXOSC_TYPE_DOUBLE:
+            dest = static_cast<float>(msg.getArgAsDouble(index));
+            break;
+        case OFXOSC_TYPE_TRUE:
+        case OFXOSC_TYPE_FALSE:
+            dest = msg.getArgAsBool(index);
+            break;
         default:
             dest = 0;
             break;
@@ -150,7 +605,7 @@ inline void ofxOscListener::getData(const ofxOscMessage& msg, int index, float&
     }
 }
 
-inline void ofxOscListener::getData(const ofxOscMessage& msg, int index, double& dest) {
+inline void ofxOscListener::getData(const ofxEasyOscMessageView& msg, int index, double& dest) {
     if (msg.getNumArgs()){
         switch (msg.getArgType(index)){
         case OFXOSC_TYPE_FLOAT:
@@ -159,6 +614,16 @@ inline void ofxOscListener::getData(const ofxOscMessage& msg, int index, double&
         case OFXOSC_TYPE_INT32:
             dest = msg.getArgAsInt32(index);
             break;
+        case OFXOSC_TYPE_INT64:
+            dest = static_cast<double>(msg.getArgAsInt64(index));
+            break;
+        case OFXOSC_TYPE_DOUBLE:
+            dest = msg.getArgAsDouble(index);
+            break;
+        case OFXOSC_TYPE_TRUE:
+        case OFXOSC_TYPE_FALSE:
+            dest = msg.getArgAsBool(index);
+            break;
         default:
             dest = 0;
             break;
@@ -166,32 +631,191 @@ inline void ofxOscListener::getData(const ofxOscMessage& msg, int index, double&
     }
 }
 
-inline void ofxOscListener::getData(const ofxOscMessage& msg, int index, string& dest) {
+inline void ofxOscListener::getData(const ofxEasyOscMessageView& msg, int index, long& dest) {
     if (msg.getNumArgs()){
         switch (msg.getArgType(index)){
-        case OFXOSC_TYPE_STRING:
-            dest = msg.getArgAsString(index);
+        case OFXOSC_TYPE_FLOAT:
+            dest = static_cast<long>(msg.getArgAsFloat(index));
+            break;
+        case OFXOSC_TYPE_INT32:
+            dest = msg.getArgAsInt32(index);
+            break;
+        case OFXOSC_TYPE_INT64:
+            dest = static_cast<long>(msg.getArgAsInt64(index));
+            break;
+        case OFXOSC_TYPE_DOUBLE:
+            dest = static_cast<long>(msg.getArgAsDouble(index));
+            break;
+        case OFXOSC_TYPE_TIMETAG:
+            dest = static_cast<long>(msg.getArgAsTimetag(index));
+            break;
+        case OFXOSC_TYPE_TRUE:
+        case OFXOSC_TYPE_FALSE:
+            dest = msg.getArgAsBool(index);
             break;
+        default:
+            dest = 0;
+            break;
+        }
+    }
+}
+
+inline void ofxOscListener::getData(const ofxEasyOscMessageView& msg, int index, long long& dest) {
+    if (msg.getNumArgs()){
+        switch (msg.getArgType(index)){
         case OFXOSC_TYPE_FLOAT:
-            dest = ofToString(msg.getArgAsFloat(index));
+            dest = static_cast<long long>(msg.getArgAsFloat(index));
             break;
         case OFXOSC_TYPE_INT32:
-            dest = ofToString(msg.getArgAsInt32(index));
+            dest = msg.getArgAsInt32(index);
+            break;
+        case OFXOSC_TYPE_INT64:
+            dest = msg.getArgAsInt64(index);
+            break;
+        case OFXOSC_TYPE_DOUBLE:
+            dest = static_cast<long long>(msg.getArgAsDouble(index));
+            break;
+        case OFXOSC_TYPE_TIMETAG:
+            dest = static_cast<long long>(msg.getArgAsTimetag(index));
+            break;
+        case OFXOSC_TYPE_TRUE:
+        case OFXOSC_TYPE_FALSE:
+            dest = msg.getArgAsBool(index);
             break;
         default:
+            dest = 0;
+            break;
+        }
+    }
+}
+
+inline void ofxOscListener::getData(const ofxEasyOscMessageView& msg, int index, ofxEasyOscTimetag& dest) {
+    if (msg.getNumArgs()){
+        switch (msg.getArgType(index)){
+        case OFXOSC_TYPE_TIMETAG:
+            dest.value = msg.getArgAsTimetag(index);
+            break;
+        case OFXOSC_TYPE_INT64:
+            dest.value = static_cast<uint64_t>(msg.getArgAsInt64(index));
+            break;
+        default:
+            dest = ofxEasyOscTimetag();
+            break;
+        }
+    }
+}
+
+// format numbers without streams or temporary strings. return the number of characters written.
+inline size_t ofxEasyOscFormatNumber(char* buf, size_t size, int64_t value){
+#ifdef OFXEASYOSC_HAS_STRING_VIEW
+    auto result = std::to_chars(buf, buf + size, value);
+    return (result.ec == std::errc()) ? static_cast<size_t>(result.ptr - buf) : 0;
+#else
+    int n = snprintf(buf, size, "%lld", static_cast<long long>(value));
+    return (n > 0 && static_cast<size_t>(n) < size) ? n : 0;
+#endif
+}
+
+inline size_t ofxEasyOscFormatNumber(char* buf, size_t size, int32_t value){
+    return ofxEasyOscFormatNumber(buf, size, static_cast<int64_t>(value));
+}
+
+inline size_t ofxEasyOscFormatNumber(char* buf, size_t size, double value){
+#if defined(OFXEASYOSC_HAS_STRING_VIEW) && defined(__cpp_lib_to_chars)
+    auto result = std::to_chars(buf, buf + size, value);
+    return (result.ec == std::errc()) ? static_cast<size_t>(result.ptr - buf) : 0;
+#else
+    // no floating point std::to_chars
+    int n = snprintf(buf, size, "%g", value);
+    return (n > 0 && static_cast<size_t>(n) < size) ? n : 0;
+#endif
+}
+
+inline size_t ofxEasyOscFormatNumber(char* buf, size_t size, float value){
+#if defined(OFXEASYOSC_HAS_STRING_VIEW) && defined(__cpp_lib_to_chars)
+    auto result = std::to_chars(buf, buf + size, value);
+    return (result.ec == std::errc()) ? static_cast<size_t>(result.ptr - buf) : 0;
+#else
+    return ofxEasyOscFormatNumber(buf, size, static_cast<double>(value));
+#endif
+}
+
+inline void ofxOscListener::getData(const ofxEasyOscMessageView& msg, int index, string& dest) {
+    getString(msg, index, dest);
+}
+
+template <typename TString>
+inline void ofxOscListener::getString(const ofxEasyOscMessageView& msg, int index, TString& dest) {
+    if (msg.getNumArgs()){
+        char buf[32];
+        size_t length = 0;
+        switch (msg.getArgType(index)){
+        case OFXOSC_TYPE_STRING:
+        case OFXOSC_TYPE_SYMBOL: {
+            // assign() reuses the capacity of 'dest'
+            const char* str = msg.getArgAsCString(index, &length);
+            dest.assign(str, length);
+            return;
+        }
+        case OFXOSC_TYPE_FLOAT:
+            length = ofxEasyOscFormatNumber(buf, sizeof(buf), msg.getArgAsFloat(index));
+            break;
+        case OFXOSC_TYPE_INT32:
+            length = ofxEasyOscFormatNumber(buf, sizeof(buf), msg.getArgAsInt32(index));
+            break;
+        case OFXOSC_TYPE_INT64:
+            length = ofxEasyOscFormatNumber(buf, sizeof(buf), msg.getArgAsInt64(index));
             break;
+        case OFXOSC_TYPE_DOUBLE:
+            length = ofxEasyOscFormatNumber(buf, sizeof(buf), msg.getArgAsDouble(index));
+            break;
+        default:
+            return;
+        }
+        dest.assign(buf, length);
+    }
+}
+
+#ifdef OFXEASYOSC_HAS_STRING_VIEW
+inline void ofxOscListener::getData(const ofxEasyOscMessageView& msg, int index, std::string_view& dest) {
+    if (msg.getNumArgs()){
+        dest = msg.getArgAsStringView(index);
+    }
+}
+#endif
+
+#ifdef OFXEASYOSC_HAS_PMR
+inline void ofxOscListener::getData(const ofxEasyOscMessageView& msg, int index, std::pmr::string& dest) {
+    getString(msg, index, dest);
+}
+
+template <typename T>
+inline void ofxOscListener::getData(const ofxEasyOscMessageView& msg, int index, std::pmr::vector<T>& dest){
+    // N arguments can fill N/step elements (step is 1 for numbers/strings, 2, 3, 4, 9 or 16 for vectors/matrices)
+    static_assert(ofxEasyOscArgTraits<T>::count > 0, "ofxEasyOsc: bad element type for std::pmr::vector");
+    const int step = ofxEasyOscArgTraits<T>::count;
+    if constexpr (ofxEasyOscIsQuantizable<T>::value){
+        if (getQuantized(msg, dest, step)){
+            return;
         }
     }
+    const int length = msg.getNumArgs() / step;
+    // elements (e.g. std::pmr::string) get the vector's allocator
+    dest.resize(length);
+    for (int i = 0; i < length; ++i){
+        getData(msg, i * step, dest[i]);
+    }
 }
+#endif
 
-inline void ofxOscListener::getData(const ofxOscMessage& msg, int index, ofVec2f& dest) {
+inline void ofxOscListener::getData(const ofxEasyOscMessageView& msg, int index, ofVec2f& dest) {
     if (msg.getNumArgs() >= 2){
         getData(msg, index, dest.x);
         getData(msg, index+1, dest.y);
     }
 }
 
-inline void ofxOscListener::getData(const ofxOscMessage& msg, int index, ofVec3f& dest) {
+inline void ofxOscListener::getData(const ofxEasyOscMessageView& msg, int index, ofVec3f& dest) {
     if (msg.getNumArgs() >= 3){
         getData(msg, index, dest.x);
         getData(msg, index+1, dest.y);
@@ -199,7 +823,7 @@ inline void ofxOscListener::getData(const ofxOscMessage& msg, int index, ofVec3f
     }
 }
 
-inline void ofxOscListener::getData(const ofxOscMessage& msg, int index, ofVec4f& dest) {
+inline void ofxOscListener::getData(const ofxEasyOscMessageView& msg, int index, ofVec4f& dest) {
     if (msg.getNumArgs() >= 4){
         getData(msg, index, dest.x);
         getData(msg, index+1, dest.y);
@@ -208,7 +832,7 @@ inline void ofxOscListener::getData(const ofxOscMessage& msg, int index, ofVec4f
     }
 }
 
-inline void ofxOscListener::getData(const ofxOscMessage& msg, int index, ofMatrix3x3& dest) {
+inline void ofxOscListener::getData(const ofxEasyOscMessageView& msg, int index, ofMatrix3x3& dest) {
     if (msg.getNumArgs() >= 9){
         for (int i = 0; i < 9; ++i){
             getData(msg, index+i, dest[i]);
@@ -216,9 +840,9 @@ inline void ofxOscListener::getData(const ofxOscMessage& msg, int index, ofMatri
     }
 }
 
-inline void ofxOscListener::getData(const ofxOscMessage& msg, int index, ofMatrix4x4& dest) {
-    if (msg.getNumArgs() >= 12){
-        for (int i = 0; i < 12; ++i){
+inline void ofxOscListener::getData(const ofxEasyOscMessageView& msg, int index, ofMatrix4x4& dest) {
+    if (msg.getNumArgs() >= 16){
+        for (int i = 0; i < 16; ++i){
             getData(msg, index+i, dest.getPtr()[i]);
         }
     }
@@ -226,7 +850,7 @@ inline void ofxOscListener::getData(const ofxOscMessage& msg, int index, ofMatri
 
 // get container of simple one-dimensional types
 template <typename T, template <typename E, typename Allocater = std::allocator<E>> class Container>
-inline void ofxOscListener::getData(const ofxOscMessage& msg, int index, Container<T>& dest){
+inline void ofxOscListener::getData(const ofxEasyOscMessageView& msg, int index, Container<T>& dest){
     int length = msg.getNumArgs();
     dest.resize(length);
 
@@ -236,10 +860,82 @@ inline void ofxOscListener::getData(const ofxOscMessage& msg, int index, Contain
     }
 }
 
+// get container of floats (also from a quantized blob)
+template <template <typename E, typename Allocater = std::allocator<E>> class Container>
+inline void ofxOscListener::getData(const ofxEasyOscMessageView& msg, int index, Container<float>& dest){
+    if (getQuantized(msg, dest, 1)){
+        return;
+    }
+    const int length = msg.getNumArgs();
+    dest.resize(length);
+
+    auto it = dest.begin();
+    for (int i = 0; i < length; ++i, ++it){
+        *it = msg.getArgAsFloat(i);
+    }
+}
+
+// get container of bools (also from a bit-packed blob)
+template <template <typename E, typename Allocater = std::allocator<E>> class Container>
+inline void ofxOscListener::getData(const ofxEasyOscMessageView& msg, int index, Container<bool>& dest){
+    const char* bits;
+    size_t size;
+    if (msg.getArgAsBlob(0, bits, size)){
+        // bit count followed by the bits (LSB first)
+        if (size < 4){
+            return;
+        }
+        size_t length = ofxEasyOscRead32(bits);
+        if (length > (size - 4) * 8){
+            length = (size - 4) * 8;
+        }
+        dest.resize(length);
+        auto it = dest.begin();
+        for (size_t i = 0; i < length; ++i, ++it){
+            *it = (bits[4 + i / 8] >> (i % 8)) & 1;
+        }
+    } else {
+        const int length = msg.getNumArgs();
+        dest.resize(length);
+        auto it = dest.begin();
+        for (int i = 0; i < length; ++i, ++it){
+            *it = msg.getArgAsBool(i);
+        }
+    }
+}
+
+// get std::bitset (also from a bit-packed blob)
+template <size_t N>
+inline void ofxOscListener::getData(const ofxEasyOscMessageView& msg, int index, std::bitset<N>& dest){
+    const char* bits;
+    size_t size;
+    dest.reset();
+    if (msg.getArgAsBlob(0, bits, size)){
+        if (size < 4){
+            return;
+        }
+        size_t length = ofxEasyOscRead32(bits);
+        if (length > (size - 4) * 8){
+            length = (size - 4) * 8;
+        }
+        for (size_t i = 0; i < length && i < N; ++i){
+            dest[i] = (bits[4 + i / 8] >> (i % 8)) & 1;
+        }
+    } else {
+        const size_t length = msg.getNumArgs();
+        for (size_t i = 0; i < length && i < N; ++i){
+            dest[i] = msg.getArgAsBool(static_cast<int>(i));
+        }
+    }
+}
+
 // helper function for lists of ofVec2f, ofVec3f, ofVec4f, ofMatrix3x3 and ofMatrix4x4
 template <typename TVec, template <typename E, typename Allocater = std::allocator<E>> class Container>
-inline void ofxOscListener::getVec(const ofxOscMessage& msg, Container<TVec>& dest, const int size){
-    // N arguments can fill N/size objects (size is 2, 3, 4, 9 or 12)
+inline void ofxOscListener::getVec(const ofxEasyOscMessageView& msg, Container<TVec>& dest, const int size){
+    if (getQuantized(msg, dest, size)){
+        return;
+    }
+    // N arguments can fill N/size objects (size is 2, 3, 4, 9 or 16)
     // integer division makes sure that only complete objects are created.
     const int length = msg.getNumArgs()/size;
     dest.resize(length);
@@ -250,6 +946,38 @@ inline void ofxOscListener::getVec(const ofxOscMessage& msg, Container<TVec>& de
     }
 }
 
+template <typename TContainer>
+inline bool ofxOscListener::getQuantized(const ofxEasyOscMessageView& msg, TContainer& dest, size_t size){
+    const char* blob;
+    size_t blobSize;
+    if (!msg.getArgAsBlob(0, blob, blobSize)){
+        return false;
+    }
+    const size_t count = ofxEasyOscQuantizedCount(blob, blobSize);
+    if (!count){
+        return false;
+    }
+    typedef typename TContainer::value_type element;
+    static_assert(sizeof(element) % sizeof(float) == 0, "element must consist of nothing but floats");
+    // only complete elements
+    const size_t length = count / size;
+    dest.resize(length);
+    if (!length){
+        return true;
+    }
+    if (std::is_same<TContainer, std::vector<element, typename TContainer::allocator_type>>::value){
+        // contiguous (std::vector, std::pmr::vector): decode in one go
+        ofxEasyOscDequantizeFloats(blob, 0, length * size, reinterpret_cast<float*>(&*dest.begin()));
+    } else {
+        size_t first = 0;
+        for (auto& e : dest){
+            ofxEasyOscDequantizeFloats(blob, first, size, reinterpret_cast<float*>(&e));
+            first += size;
+        }
+    }
+    return true;
+}
+
 //*--------------------------------------------------------------------------------------------------*//
 
 ///ofxOscVariable
@@ -260,8 +988,9 @@ class ofxOscVariable : public ofxOscListener {
         //constructor
         ofxOscVariable(T* var_) : var(var_) {}
         ~ofxOscVariable() {}
+        static_assert(!std::is_same<T, ofxEasyOscMessageView>::value, "ofxEasyOsc: ofxEasyOscMessageView is only valid during dispatch, register a function instead");
         // assigns OSC data to the variable.
-        void dispatch(const ofxOscMessage & msg){
+        void dispatch(const ofxEasyOscMessageView & msg, ofxEasyOscMessagePool & /*pool*/){
             if (var) {
                 getData(msg, 0, *var);
 			}
@@ -288,11 +1017,9 @@ class ofxOscFunction : public ofxOscListener {
         // constructor
         ofxOscFunction(TReturn(*func_)(TArg)) : func(func_) {}
         ~ofxOscFunction() {}
-        void dispatch(const ofxOscMessage & msg){
-            // decay: remove constness and references to get the bare type
-            typename std::decay<TArg>::type arg = {};
-            getData(msg, 0, arg);
-            func(arg);
+        void dispatch(const ofxEasyOscMessageView & msg, ofxEasyOscMessagePool & pool){
+            Argument<TArg> arg(msg, pool);
+            func(arg.value);
         }
         bool compare(ofxOscListener * listener) {
             if (auto * ptr = dynamic_cast<ofxOscFunction<TReturn, TArg>*>(listener)){
@@ -314,7 +1041,7 @@ class ofxOscFunction<TReturn, void> : public ofxOscListener {
         // constructor
         ofxOscFunction(TReturn(*func_)()) : func(func_) {}
         ~ofxOscFunction() {}
-        void dispatch(const ofxOscMessage & msg){
+        void dispatch(const ofxEasyOscMessageView & msg, ofxEasyOscMessagePool & pool){
             func();
         }
         bool compare(ofxOscListener * listener) {
@@ -340,11 +1067,9 @@ class ofxOscLambdaFunction : public ofxOscListener {
         // constructor
         ofxOscLambdaFunction(const function<void(TArg)> & func_) : func(func_) {}
         ~ofxOscLambdaFunction() {}
-        void dispatch(const ofxOscMessage & msg){
-            // decay: remove constness and references to get the bare type
-            typename std::decay<TArg>::type arg = {};
-            getData(msg, 0, arg);
-            func(arg);
+        void dispatch(const ofxEasyOscMessageView & msg, ofxEasyOscMessagePool & pool){
+            Argument<TArg> arg(msg, pool);
+            func(arg.value);
         }
         bool compare(ofxOscListener * listener) {
             return false;
@@ -365,7 +1090,7 @@ class ofxOscLambdaFunction<void> : public ofxOscListener {
         // constructor
         ofxOscLambdaFunction(const function<void()> & func_) : func(func_) {}
         ~ofxOscLambdaFunction() {}
-        void dispatch(const ofxOscMessage & msg){
+        void dispatch(const ofxEasyOscMessageView & /*msg*/, ofxEasyOscMessagePool & /*pool*/){
             func();
         }
         bool compare(ofxOscListener * listener) {
@@ -390,12 +1115,10 @@ class ofxOscMemberFunction : public ofxOscListener {
         // constructor
         ofxOscMemberFunction(TObject* obj_, TReturn(TObject::*func_)(TArg)) : obj(obj_), func(func_) {}
         ~ofxOscMemberFunction() {}
-        void dispatch(const ofxOscMessage & msg){
-            // remove constness and references to get the bare type
-            typename decay<TArg>::type arg = {};
-            getData(msg, 0, arg);
+        void dispatch(const ofxEasyOscMessageView & msg, ofxEasyOscMessagePool & pool){
+            Argument<TArg> arg(msg, pool);
             if (obj) {
-                (obj->*func)(arg);
+                (obj->*func)(arg.value);
             }
         }
         bool compare(ofxOscListener * listener) {
@@ -418,7 +1141,7 @@ class ofxOscMemberFunction<TObject, TReturn, void> : public ofxOscListener {
     public:
         ofxOscMemberFunction(TObject* obj_, TReturn(TObject::*func_)()) : obj(obj_), func(func_) {}
         ~ofxOscMemberFunction () {}
-        void dispatch(const ofxOscMessage & msg){
+        void dispatch(const ofxEasyOscMessageView & msg, ofxEasyOscMessagePool & pool){
             if (obj){
                 (obj->*func)();
             }
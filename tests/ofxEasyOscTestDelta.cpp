@@ -0,0 +1,189 @@
+// Delta encoding: a fuzz run of ofxEasyOscDeltaDecoder::patch() with corrupted and truncated deltas (they must never touch
+// memory outside the base, and intact deltas must reproduce the frame exactly), followed by a loopback run with 20% loss
+// where the receiver has to resynchronize at the keyframes and must never dispatch a wrong frame.
+
+#include "ofxEasyOsc.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <thread>
+
+static const int receiverPort = 19433;
+static const int numFuzzFrames = 3000;
+static const int numFrames = 400;
+static const int keyframeInterval = 10;
+static const size_t numValues = 256;
+
+class PatchFuzz {
+public:
+    PatchFuzz() : numPatched(0), numWrong(0), random(5), bTainted(false) {
+        encoder.add("/leds", 1000);
+    }
+
+    void run(){
+        for (int n = 0; n < numFuzzFrames; ++n){
+            // a new size every few frames, so deltas of the old size meet a base of the new one
+            if (n % 6 == 0){
+                values.resize(1 + random() % 300);
+                encoder.requestKeyframes();
+            }
+            for (int i = 0; i < 3; ++i){
+                values[random() % values.size()] = static_cast<int32_t>(random() % 3);
+            }
+            writer.begin("/leds", 5, values.size());
+            for (auto value : values){
+                writer.addInt32(value);
+            }
+            writer.end();
+            if (!encoder.encode(writer.data(), writer.size(), "/leds", 5)){
+                continue;
+            }
+            packet.assign(encoder.data(), encoder.data() + encoder.size());
+            // corrupt a quarter of the deltas: flipped bytes or a blob with words missing (a well-formed message)
+            const bool bKeyframe = packet[0] == '#';
+            bool bCorrupt = false;
+            if (!bKeyframe && random() % 4 == 0){
+                bCorrupt = true;
+                if (random() % 2){
+                    for (int i = 0; i < 4; ++i){
+                        packet[random() % packet.size()] = char(random());
+                    }
+                } else {
+                    truncate();
+                }
+            }
+            apply(bKeyframe, bCorrupt);
+        }
+    }
+
+    uint64_t numPatched;
+    int numWrong;
+
+    uint64_t getNumMissed() const { return decoder.getStats().numMissed; }
+
+protected:
+    // rewrite the delta with a shorter blob
+    void truncate(){
+        const char* address;
+        const char* blob;
+        size_t length, blobSize;
+        if (!msg.parse(packet.data(), packet.size()) || !(address = msg.getArgAsCString(0, &length))
+                || !msg.getArgAsBlob(2, blob, blobSize) || blobSize < 8){
+            return;
+        }
+        ofxEasyOscWriter truncated;
+        truncated.begin(OFXEASYOSC_DELTA_ADDRESS, 3, 3);
+        truncated.addString(address, length);
+        truncated.addInt32(msg.getArgAsInt32(1));
+        truncated.addBlob(blob, blobSize - 1 - random() % (blobSize / 2));
+        truncated.end();
+        packet.assign(truncated.data(), truncated.data() + truncated.size());
+    }
+
+    void apply(bool bKeyframe, bool bCorrupt){
+        if (bKeyframe){
+            bool bHeader = false;
+            uint32_t frame = 0;
+            ofxEasyOscParsePacket(packet.data(), packet.size(), [&](const char* data, size_t size){
+                if (msg.parse(data, size)){
+                    if (bHeader){
+                        decoder.keyframe(msg, frame);
+                        bTainted = false;
+                        bHeader = false;
+                    } else {
+                        bHeader = ofxEasyOscDeltaDecoder::readKeyframe(msg, frame);
+                    }
+                }
+            });
+            return;
+        }
+        // an exact copy, so reading past the end of the packet hits the sanitizer's red zone
+        const vector<char> exact(packet);
+        size_t size = 0;
+        if (!msg.parse(exact.data(), exact.size()) || !decoder.patch(msg, buffer, size) || !size){
+            return;
+        }
+        ++numPatched;
+        // a corrupted delta which has been accepted spoils the base until the next keyframe
+        if (bCorrupt){
+            bTainted = true;
+        } else if (!bTainted && (size != writer.size() || std::memcmp(buffer.data(), writer.data(), size) != 0)){
+            ++numWrong;
+        }
+    }
+
+    ofxEasyOscDeltaEncoder encoder;
+    ofxEasyOscDeltaDecoder decoder;
+    ofxEasyOscWriter writer;
+    ofxEasyOscMessageView msg;
+    vector<int32_t> values;
+    vector<char> packet;
+    vector<char> buffer;
+    std::mt19937 random;
+    bool bTainted;
+};
+
+int main(){
+    PatchFuzz fuzz;
+    fuzz.run();
+    std::printf("fuzz: %d frames, patched %llu, missed %llu, wrong %d\n", numFuzzFrames, (unsigned long long)fuzz.numPatched,
+        (unsigned long long)fuzz.getNumMissed(), fuzz.numWrong);
+
+    // loopback: every frame carries its number in the first value, the others are derived from it (only a few change per frame)
+    ofxEasyOscReceiver receiver(receiverPort);
+    vector<int> received(numFrames, 0);
+    int numWrong = 0;
+    receiver.add("/leds", function<void(const ofxEasyOscMessageView&)>([&](const ofxEasyOscMessageView& msg){
+        const int frame = msg.getNumArgs() == int(numValues) ? msg.getArgAsInt32(0) : -1;
+        if (frame < 0 || frame >= numFrames){
+            ++numWrong;
+            return;
+        }
+        for (size_t i = 1; i < numValues; ++i){
+            if (msg.getArgAsInt32(int(i)) != frame / int32_t(i + 1)){
+                ++numWrong;
+                return;
+            }
+        }
+        ++received[frame];
+    }));
+
+    ofxEasyOscSender sender("127.0.0.1", receiverPort);
+    sender.setDelta("/leds", keyframeInterval).setImpairment(ofxEasyOscImpairment(0.2, 0, 0, 7));
+    vector<int32_t> values(numValues, 0);
+    for (int frame = 0; frame < numFrames; ++frame){
+        values[0] = frame;
+        for (size_t i = 1; i < numValues; ++i){
+            values[i] = frame / int32_t(i + 1);
+        }
+        sender.send("/leds", values);
+        sender.update();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        receiver.update();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    receiver.update();
+
+    // frames which arrived after a gap show that the receiver has caught up again
+    int numReceived = 0;
+    int numDuplicates = 0;
+    int numResyncs = 0;
+    for (int frame = 0; frame < numFrames; ++frame){
+        numReceived += received[frame] > 0;
+        numDuplicates += received[frame] > 1;
+        numResyncs += frame > 0 && received[frame] && !received[frame - 1];
+    }
+    const ofxEasyOscDeltaStats& stats = receiver.getDeltaStats();
+    std::printf("loopback: %d frames, received %d, duplicates %d, wrong %d, resyncs %d, lost %llu\n", numFrames, numReceived,
+        numDuplicates, numWrong, numResyncs, (unsigned long long)sender.getImpairmentStats().numLost);
+    std::printf("receiver: patched %llu, missed %llu\n", (unsigned long long)stats.numPatched, (unsigned long long)stats.numMissed);
+
+    bool bOk = fuzz.numWrong == 0 && fuzz.numPatched > 0 && numWrong == 0 && numDuplicates == 0;
+    // losses must have happened and the receiver must have recovered from them, by patching as well
+    if (!numResyncs || !stats.numPatched || !stats.numMissed){
+        std::printf("the receiver never resynchronized\n");
+        bOk = false;
+    }
+    std::printf(bOk ? "passed\n" : "FAILED\n");
+    return bOk ? 0 : 1;
+}
@@ -0,0 +1,100 @@
+// Round trips through the LZ4 block codec: 2000 random inputs (from almost constant to incompressible, up to the maximum
+// datagram size) have to come back unchanged. Truncated and corrupted blocks must be rejected or decoded into the
+// destination without writing past it (checked with guard bytes behind the buffer).
+
+#include "ofxEasyOsc.h"
+#include <algorithm>
+#include <cstdio>
+#include <random>
+
+static const int numCases = 2000;
+static const size_t maxSize = 65536;
+static const size_t numGuardBytes = 64;
+static const char guard = char(0xa5);
+
+// decompress into a buffer with guard bytes behind 'destSize'. returns false if the guard bytes have been overwritten.
+static bool decompressGuarded(const char* src, size_t size, vector<char>& dest, size_t destSize, bool& bResult){
+    dest.assign(destSize + numGuardBytes, guard);
+    bResult = ofxEasyOscLz4Decompress(src, size, dest.data(), destSize);
+    for (size_t i = destSize; i < dest.size(); ++i){
+        if (dest[i] != guard){
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(){
+    std::mt19937 random(1);
+    vector<uint32_t> table;
+    vector<char> src, compressed, dest;
+    int numFailed = 0;
+    int numOverflows = 0;
+    int numTruncatedAccepted = 0;
+    size_t bytesIn = 0, bytesOut = 0;
+    for (int n = 0; n < numCases; ++n){
+        // random bytes of a small or large alphabet, runs and repeats of earlier data (near and far, also overlapping)
+        const size_t size = random() % maxSize;
+        const int alphabet = 1 + random() % 256;
+        src.resize(size);
+        for (size_t i = 0; i < size;){
+            const size_t length = std::min<size_t>(1 + random() % 300, size - i);
+            switch (i > 0 ? random() % 3 : 0){
+            case 0:
+                for (size_t k = 0; k < length; ++k){
+                    src[i + k] = char(random() % alphabet);
+                }
+                break;
+            case 1:
+                std::fill(src.begin() + i, src.begin() + i + length, char(random()));
+                break;
+            default:
+                const size_t from = i - 1 - random() % i;
+                for (size_t k = 0; k < length; ++k){
+                    src[i + k] = src[from + k];
+                }
+            }
+            i += length;
+        }
+        compressed.resize(ofxEasyOscLz4Bound(size));
+        const size_t compressedSize = ofxEasyOscLz4Compress(src.data(), size, compressed.data(), table);
+        bytesIn += size;
+        bytesOut += compressedSize;
+
+        bool bResult;
+        if (!decompressGuarded(compressed.data(), compressedSize, dest, size, bResult)){
+            ++numOverflows;
+        }
+        if (!bResult || std::memcmp(dest.data(), src.data(), size) != 0){
+            ++numFailed;
+        }
+        // a destination which is too small
+        if (size > 1){
+            if (!decompressGuarded(compressed.data(), compressedSize, dest, size / 2, bResult)){
+                ++numOverflows;
+            }
+            numTruncatedAccepted += bResult;
+        }
+        // a truncated block
+        if (compressedSize > 2){
+            if (!decompressGuarded(compressed.data(), compressedSize / 2, dest, size, bResult)){
+                ++numOverflows;
+            }
+        }
+        // corrupted bytes (the result is garbage, but it must stay inside the buffer)
+        if (compressedSize > 0){
+            for (int i = 0; i < 4; ++i){
+                compressed[random() % compressedSize] = char(random());
+            }
+            if (!decompressGuarded(compressed.data(), compressedSize, dest, size, bResult)){
+                ++numOverflows;
+            }
+        }
+    }
+    std::printf("%d cases, %zu bytes in, %zu bytes out\n", numCases, bytesIn, bytesOut);
+    std::printf("round trip failures %d, overflows %d, accepted into a short buffer %d\n", numFailed, numOverflows, numTruncatedAccepted);
+
+    const bool bOk = numFailed == 0 && numOverflows == 0 && numTruncatedAccepted == 0;
+    std::printf(bOk ? "passed\n" : "FAILED\n");
+    return bOk ? 0 : 1;
+}
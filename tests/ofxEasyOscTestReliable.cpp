@@ -0,0 +1,136 @@
+// Loopback test for reliable messages: the sender talks to the receiver through a relay which drops, duplicates and reorders
+// datagrams in both directions (data and acknowledgements). Every reliable message has to be dispatched exactly once.
+
+#include "ofxEasyOsc.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <thread>
+
+static const int relayPort = 19431;
+static const int receiverPort = 19432;
+static const int numMessages = 300;
+// a full buffer gives up the oldest message, so the test never sends more than that
+static const size_t bufferSize = 32;
+
+// relays datagrams between the sender and the receiver with 20% loss, 10% duplication and 20% reordering
+class LossyRelay {
+public:
+    LossyRelay() : numRelayed(0), numLost(0), numDuplicated(0), numReordered(0), random(1) {
+        socket.bind(relayPort);
+        receiver.set("127.0.0.1", receiverPort);
+    }
+
+    void update(){
+        // datagrams held back in the last round are overtaken by the ones of this round
+        vector<Datagram> late;
+        late.swap(held);
+        ofxEasyOscEndpoint from;
+        int size;
+        while ((size = socket.receive(buffer, sizeof(buffer), &from)) > 0){
+            if (!(from == receiver)){
+                sender = from;
+            }
+            relay(buffer, size, from == receiver ? sender : receiver);
+        }
+        for (auto& datagram : late){
+            socket.sendTo(datagram.data.data(), datagram.data.size(), datagram.to);
+        }
+    }
+
+    uint64_t numRelayed, numLost, numDuplicated, numReordered;
+
+protected:
+    struct Datagram {
+        vector<char> data;
+        ofxEasyOscEndpoint to;
+    };
+
+    void relay(const char* data, size_t size, const ofxEasyOscEndpoint& to){
+        ++numRelayed;
+        const double r = std::uniform_real_distribution<double>(0, 1)(random);
+        if (r < 0.2){
+            ++numLost;
+        } else if (r < 0.4){
+            Datagram datagram = { vector<char>(data, data + size), to };
+            held.push_back(datagram);
+            ++numReordered;
+        } else {
+            socket.sendTo(data, size, to);
+            if (r < 0.5){
+                socket.sendTo(data, size, to);
+                ++numDuplicated;
+            }
+        }
+    }
+
+    ofxEasyOscUdpSocket socket;
+    ofxEasyOscEndpoint sender, receiver;
+    vector<Datagram> held;
+    std::mt19937 random;
+    char buffer[65536];
+};
+
+int main(){
+    LossyRelay relay;
+    ofxEasyOscReceiver receiver(receiverPort);
+    vector<int> received(numMessages, 0);
+    int numInvalid = 0;
+    receiver.add("/cue", function<void(int)>([&](int i){
+        if (i >= 0 && i < numMessages){
+            ++received[i];
+        } else {
+            ++numInvalid;
+        }
+    }));
+    receiver.add("/noise", function<void(float)>([](float){}));
+
+    ofxEasyOscSender sender("127.0.0.1", relayPort);
+    sender.setReliable("/cue").setReliableTimeout(10, 100).setReliableBufferSize(bufferSize);
+
+    // send in bursts as long as there is room, then keep going until everything has been acknowledged
+    // and a little longer, so late duplicates would still be counted
+    typedef std::chrono::steady_clock clock;
+    const clock::time_point start = clock::now();
+    clock::time_point done;
+    int numSent = 0;
+    while (clock::now() - start < std::chrono::seconds(20)){
+        for (int i = 0; i < 10 && numSent < numMessages && sender.getReliableSender().getNumPending() < bufferSize; ++i){
+            sender.send("/cue", numSent++);
+            sender.send("/noise", 0.5f);
+        }
+        sender.update();
+        relay.update();
+        receiver.update();
+        if (numSent == numMessages && sender.getReliableSender().getNumPending() == 0){
+            if (done == clock::time_point()){
+                done = clock::now();
+            } else if (clock::now() - done > std::chrono::milliseconds(200)){
+                break;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    int numMissing = 0;
+    int numDuplicates = 0;
+    for (int i = 0; i < numMessages; ++i){
+        numMissing += received[i] == 0;
+        numDuplicates += received[i] > 1;
+    }
+    const ofxEasyOscReliableStats& stats = sender.getReliableSender().getStats();
+    std::printf("sent %d, missing %d, duplicates %d, invalid %d, pending %zu, failed %llu, retransmitted %llu\n",
+        numSent, numMissing, numDuplicates, numInvalid, sender.getReliableSender().getNumPending(),
+        (unsigned long long)stats.numFailed, (unsigned long long)stats.numRetransmitted);
+    std::printf("relay: lost %llu, duplicated %llu, reordered %llu of %llu\n", (unsigned long long)relay.numLost,
+        (unsigned long long)relay.numDuplicated, (unsigned long long)relay.numReordered, (unsigned long long)relay.numRelayed);
+
+    bool bOk = numMissing == 0 && numDuplicates == 0 && numInvalid == 0 && stats.numFailed == 0;
+    // make sure the relay did its job, otherwise the test proves nothing
+    if (!relay.numLost || !relay.numDuplicated || !relay.numReordered){
+        std::printf("the relay didn't impair anything\n");
+        bOk = false;
+    }
+    std::printf(bOk ? "passed\n" : "FAILED\n");
+    return bOk ? 0 : 1;
+}